@@ -0,0 +1,44 @@
+#include "BookMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static char g_formatBuffer[64];
+
+const char* formatNumber(float value) {
+    if (value >= 1000000) {
+        snprintf(g_formatBuffer, sizeof(g_formatBuffer), "%.2fM", value / 1000000);
+    } else if (value >= 1000) {
+        snprintf(g_formatBuffer, sizeof(g_formatBuffer), "%.2fK", value / 1000);
+    } else {
+        snprintf(g_formatBuffer, sizeof(g_formatBuffer), "%.2f", value);
+    }
+    return g_formatBuffer;
+}
+
+int formatQuantity(char* buffer, size_t size, int64_t raw, int decimals) {
+    double value = fixedToDouble(raw, decimals);
+    if (value >= 1000000) return snprintf(buffer, size, "%.2fM", value / 1000000);
+    if (value >= 1000) return snprintf(buffer, size, "%.2fK", value / 1000);
+
+    // 123.4, 12.34, 1.234, 0.1234, 0.001234; never more digits than the scale has
+    int shown = value >= 1 ? 3 - static_cast<int>(std::floor(std::log10(value)))
+                           : value > 0 ? 3 + static_cast<int>(std::ceil(-std::log10(value))) : 0;
+    return formatFixed(buffer, size, raw, decimals, std::clamp(shown, 0, std::max(decimals, 0)));
+}
+
+OrderFlowMetrics calculateOrderFlow(const OrderFlow& flow) {
+    OrderFlowMetrics metrics = {};
+    metrics.buyVolume = flow.buyVolume;
+    metrics.sellVolume = flow.sellVolume;
+    metrics.netFlow = flow.buyVolume - flow.sellVolume;
+    metrics.imbalanceRatio = flow.imbalance;
+    metrics.cumulativeDelta = flow.cumulativeDelta;
+    metrics.trades = flow.trades;
+    for (size_t i = 0; i < OrderFlowMetrics::FLOW_HISTORY_SIZE; i++) {
+        metrics.flowHistory[i] = flow.historyAt(i);
+        metrics.maxFlow = std::max(metrics.maxFlow, std::fabs(metrics.flowHistory[i]));
+    }
+    return metrics;
+}
@@ -0,0 +1,114 @@
+//
+// Order book statistics shown by the spot and futures windows.
+//
+// Nothing here draws, so the same code runs in the programs and in the
+// benchmarks. The book functions take a BookSnapshot of any entry type with
+// int64 `price` and `volume` ticks.
+//
+
+#ifndef BOOK_METRICS_H
+#define BOOK_METRICS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "BookSnapshot.h"
+#include "FixedPoint.h"
+#include "Indicators.h"
+
+struct OrderBookMetrics {
+    float spreadAmount;
+    float spreadPercentage;
+    float midPrice;
+    float liquidityImbalance;
+    float maxBidVolume;     // Largest level shown on each side
+    float maxAskVolume;
+    PriceTrend trend;           // From the symbol's TrendTracker
+    std::chrono::system_clock::time_point lastUpdate;
+};
+
+struct MarketDepthMetrics {
+    float cumulativeBidVolume;
+    float cumulativeAskVolume;
+    float depthImbalanceRatio;
+    std::span<const int64_t> bidDepthCurve;    // Cumulative volume ticks per level
+    std::span<const int64_t> askDepthCurve;
+    int64_t maxDepthTicks;                      // The larger of the two totals, for scaling
+};
+
+struct OrderFlowMetrics {
+    static constexpr size_t FLOW_HISTORY_SIZE = OrderFlow::HISTORY;
+
+    float buyVolume;            // Taker volume over the flow window
+    float sellVolume;
+    float netFlow;              // buyVolume - sellVolume
+    float imbalanceRatio;       // netFlow / (buyVolume + sellVolume)
+    double cumulativeDelta;
+    uint32_t trades;
+    float flowHistory[FLOW_HISTORY_SIZE];  // Net flow per bucket, oldest first
+    float maxFlow;                          // Largest |net flow| in the history, for scaling
+};
+
+// Unrolls the symbol's published flow for drawing
+OrderFlowMetrics calculateOrderFlow(const OrderFlow& flow);
+
+// Formats with a K/M suffix into a shared buffer, valid until the next call
+const char* formatNumber(float value);
+
+// Formats qty ticks with a K/M suffix from a thousand up, and below that
+// exactly to four significant digits, so small levels do not read 0.00
+int formatQuantity(char* buffer, size_t size, int64_t raw, int decimals);
+
+// Both read the aggregates the engine keeps in the snapshot, so they cost the
+// same however deep the book is and however often it is drawn
+template <typename Entry, size_t Depth>
+OrderBookMetrics calculateOrderBookMetrics(const BookSnapshot<Entry, Depth>& book) {
+    OrderBookMetrics metrics = {};
+    metrics.lastUpdate = std::chrono::system_clock::now();
+    metrics.trend = book.trend;
+
+    if (book.bidCount == 0 || book.askCount == 0) return metrics;
+    const SymbolScale& scale = book.scale;
+
+    // Spread is taken in ticks so it stays exact on high priced symbols
+    float bestBid = static_cast<float>(fixedToDouble(book.bids[0].price, scale.priceDecimals));
+    float bestAsk = static_cast<float>(fixedToDouble(book.asks[0].price, scale.priceDecimals));
+
+    metrics.spreadAmount = static_cast<float>(
+        fixedToDouble(book.asks[0].price - book.bids[0].price, scale.priceDecimals));
+    metrics.midPrice = (bestAsk + bestBid) / 2.0f;
+    metrics.spreadPercentage = (metrics.spreadAmount / metrics.midPrice) * 100.0f;
+
+    // Liquidity imbalance over the levels shown
+    float bidLiquidity = static_cast<float>(fixedToDouble(book.bidVolume(), scale.qtyDecimals));
+    float askLiquidity = static_cast<float>(fixedToDouble(book.askVolume(), scale.qtyDecimals));
+    metrics.liquidityImbalance = (bidLiquidity - askLiquidity) / (bidLiquidity + askLiquidity);
+
+    metrics.maxBidVolume = static_cast<float>(fixedToDouble(book.bidMaxVolume, scale.qtyDecimals));
+    metrics.maxAskVolume = static_cast<float>(fixedToDouble(book.askMaxVolume, scale.qtyDecimals));
+    metrics.trend = book.trend;
+
+    return metrics;
+}
+
+// The curves point into `book` and live as long as it does
+template <typename Entry, size_t Depth>
+MarketDepthMetrics calculateMarketDepth(const BookSnapshot<Entry, Depth>& book) {
+    MarketDepthMetrics metrics;
+    metrics.cumulativeBidVolume = static_cast<float>(fixedToDouble(book.bidVolume(), book.scale.qtyDecimals));
+    metrics.cumulativeAskVolume = static_cast<float>(fixedToDouble(book.askVolume(), book.scale.qtyDecimals));
+    metrics.bidDepthCurve = book.bidDepthCurve();
+    metrics.askDepthCurve = book.askDepthCurve();
+    metrics.maxDepthTicks = std::max(book.bidVolume(), book.askVolume());
+
+    float totalDepth = metrics.cumulativeBidVolume + metrics.cumulativeAskVolume;
+    metrics.depthImbalanceRatio = totalDepth > 0 ?
+        (metrics.cumulativeBidVolume - metrics.cumulativeAskVolume) / totalDepth : 0;
+
+    return metrics;
+}
+
+#endif //BOOK_METRICS_H
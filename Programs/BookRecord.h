@@ -0,0 +1,51 @@
+//
+// Normalized book update records: the fixed binary layout the feed hands to
+// other processes, through the shared-memory rings (ShmRing.h) and the
+// multicast fan-out (FanoutProtocol.h). Fields are in host byte order, which
+// is little-endian on every platform the feed runs on.
+//
+// An update is a run of Level records of one symbol, the last flagged
+// BOOK_END_OF_UPDATE. A Clear record starts a snapshot: drop the symbol's
+// book, the levels that follow rebuild it. Every record of an update carries
+// the symbol's publish count, so a reader can tell which updates a snapshot
+// already contains.
+//
+
+#ifndef BOOK_RECORD_H
+#define BOOK_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+
+enum class BookRecordType : uint8_t {
+    Level = 1,      // Set a level; qty 0 removes it
+    Clear = 2       // Drop every level of the symbol; a snapshot follows
+};
+
+constexpr uint8_t BOOK_END_OF_UPDATE = 1;   // Last record of an update: the book is consistent
+constexpr size_t BOOK_SYMBOL_NAME = 32;
+
+// One normalized change, 56 bytes
+struct BookRecord {
+    BookRecordType type;
+    uint8_t side;               // 0 bid, 1 ask
+    uint8_t flags;              // BOOK_END_OF_UPDATE
+    int8_t priceDecimals;       // Scale of price and qty
+    int8_t qtyDecimals;
+    uint8_t reserved[3];
+    uint32_t symbol;            // Index in the publisher's symbol table
+    int32_t orders;             // Order count, 0 where the market has none
+    int64_t price;              // Ticks of 10^-priceDecimals
+    int64_t qty;                // Ticks of 10^-qtyDecimals
+    uint64_t version;           // Publish count of the symbol's book
+    int64_t recvNs;             // steady_clock (CLOCK_MONOTONIC) receive stamp of the frame, 0 if none
+    int64_t publishNs;          // steady_clock stamp of the publish that produced the record
+};
+static_assert(sizeof(BookRecord) == 56, "The record layout is part of the wire format");
+
+// Entry of a publisher's symbol table
+struct BookSymbolName {
+    char name[BOOK_SYMBOL_NAME];
+};
+
+#endif //BOOK_RECORD_H
@@ -0,0 +1,139 @@
+//
+// Fixed-size book snapshot and seqlock used to hand it from the websocket
+// thread to the render thread.
+//
+// The writer never waits: it bumps the sequence to odd, stores the payload and
+// bumps it back to even. A reader copies the payload and retries if the
+// sequence changed underneath it. The payload is kept in relaxed atomic words
+// so a torn read is detected rather than being a data race.
+//
+
+#ifndef BOOK_SNAPSHOT_H
+#define BOOK_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#include "FixedPoint.h"
+#include "Indicators.h"
+
+template <typename Entry, size_t Depth>
+struct BookSnapshot {
+    uint64_t version = 0;       // Incremented on every publish
+    int64_t recvNs = 0;         // Receive stamp of the newest frame in it, 0 for none
+    SymbolScale scale;
+    uint32_t bidCount = 0;
+    uint32_t askCount = 0;
+    Entry bids[Depth];
+    Entry asks[Depth];
+
+    // Aggregates kept by the book engine, copied as they are so readers
+    // never sum levels themselves. Volumes are in qty ticks.
+    int64_t bidDepth[Depth];        // bidDepth[i]: volume of bids[0..i]
+    int64_t askDepth[Depth];
+    int64_t bidMaxVolume = 0;       // Largest level in bids[]
+    int64_t askMaxVolume = 0;
+    int64_t bidBookVolume = 0;      // Every bid level of the book, not only the ones here
+    int64_t askBookVolume = 0;
+
+    PriceTrend trend = {};          // Indicators as of the newest book event
+
+    static constexpr size_t DEPTH = Depth;
+
+    std::span<const Entry> bidLevels() const { return {bids, bidCount}; }
+    std::span<const Entry> askLevels() const { return {asks, askCount}; }
+    std::span<const int64_t> bidDepthCurve() const { return {bidDepth, bidCount}; }
+    std::span<const int64_t> askDepthCurve() const { return {askDepth, askCount}; }
+    int64_t bidVolume() const { return bidCount ? bidDepth[bidCount - 1] : 0; }
+    int64_t askVolume() const { return askCount ? askDepth[askCount - 1] : 0; }
+};
+
+// The top of the book summed into price buckets of groupTicks ticks. Bucket
+// prices stand for the bucket: bids [price, price + groupTicks), asks
+// (price - groupTicks, price].
+template <typename Entry, size_t Depth>
+struct GroupedSnapshot {
+    uint64_t version = 0;       // Incremented on every publish
+    uint32_t grouping = 0;      // The VenueFeed::setGrouping() selection shown
+    int64_t groupTicks = 0;     // 0: none selected, or its step does not fit the scale; nothing below is set
+    SymbolScale scale;
+    uint32_t bidCount = 0;
+    uint32_t askCount = 0;
+    Entry bids[Depth];
+    Entry asks[Depth];
+    int64_t bidMaxVolume = 0;   // Largest bucket in bids[]
+    int64_t askMaxVolume = 0;
+
+    std::span<const Entry> bidLevels() const { return {bids, bidCount}; }
+    std::span<const Entry> askLevels() const { return {asks, askCount}; }
+};
+
+// Every price tick of the book in a window around the mid, for views that
+// show more than the top levels (the liquidity heatmap). qty[row] rests at
+// topTick - row: a bid at or below bestBid, an ask at or above bestAsk, 0 for
+// no level.
+template <size_t Rows>
+struct LadderSnapshot {
+    uint64_t version = 0;       // Incremented on every publish
+    bool filled = false;        // Both sides have levels; nothing below is set otherwise
+    SymbolScale scale;
+    int64_t topTick = 0;
+    int64_t bestBid = 0;
+    int64_t bestAsk = 0;
+    int64_t qty[Rows];
+
+    static constexpr size_t ROWS = Rows;
+};
+
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock payload must be trivially copyable");
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    // Single writer only. Never blocks.
+    void publish(const T& value) {
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        uint64_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_seq.store(seq + 2, std::memory_order_release);
+        m_writes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Copies out a consistent value; spins only while a publish overlaps the copy
+    void read(T& out) const {
+        uint64_t words[WORDS];
+        for (;;) {
+            uint64_t before = m_seq.load(std::memory_order_acquire);
+            if (!(before & 1)) {
+                for (size_t i = 0; i < WORDS; i++) {
+                    words[i] = m_words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq.load(std::memory_order_relaxed) == before) break;
+            }
+            m_readerRetries.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::memcpy(&out, words, sizeof(T));
+    }
+
+    uint64_t writes() const { return m_writes.load(std::memory_order_relaxed); }
+    uint64_t readerRetries() const { return m_readerRetries.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<uint64_t> m_seq{0};
+    std::atomic<uint64_t> m_words[WORDS] = {};
+    alignas(64) std::atomic<uint64_t> m_writes{0};
+    mutable std::atomic<uint64_t> m_readerRetries{0};
+};
+
+#endif //BOOK_SNAPSHOT_H
@@ -0,0 +1,44 @@
+#include "DepthSequencer.h"
+
+#include <utility>
+
+DepthSequencer::Result DepthSequencer::onDelta(int64_t fromVersion, int64_t toVersion, std::string_view raw) {
+    if (!m_live) {
+        buffer(fromVersion, toVersion, raw);
+        return Result::Buffered;
+    }
+    if (toVersion <= m_last) return Result::Stale;
+    if (fromVersion > m_last + 1) {
+        m_live = false;
+        m_gaps++;
+        buffer(fromVersion, toVersion, raw);
+        return Result::Gap;
+    }
+    m_last = toVersion;
+    return Result::Apply;
+}
+
+void DepthSequencer::reset() {
+    m_live = false;
+    m_last = 0;
+    m_pendingCount = 0;
+}
+
+void DepthSequencer::buffer(int64_t fromVersion, int64_t toVersion, std::string_view raw) {
+    if (m_pendingCount == MAX_PENDING) dropPending(MAX_PENDING / 2);
+    if (m_pendingCount == m_pending.size()) m_pending.emplace_back();
+
+    Pending& pending = m_pending[m_pendingCount++];
+    pending.from = fromVersion;
+    pending.to = toVersion;
+    pending.raw.assign(raw.data(), raw.size());
+}
+
+void DepthSequencer::dropPending(size_t count) {
+    if (count > m_pendingCount) count = m_pendingCount;
+    // Rotate instead of erase so the dropped strings keep their capacity
+    for (size_t i = count; i < m_pendingCount; i++) {
+        std::swap(m_pending[i - count], m_pending[i]);
+    }
+    m_pendingCount -= count;
+}
@@ -0,0 +1,88 @@
+//
+// Version tracking for incremental depth streams.
+//
+// Every incremental message covers a version range [from, to]. Until a
+// snapshot has been applied the messages are buffered; once the snapshot's
+// version is known the buffered messages that follow it are replayed and the
+// stream goes live. From then on each message must continue exactly where the
+// previous one ended, otherwise the sequencer reports a gap and falls back to
+// buffering until the next snapshot.
+//
+
+#ifndef DEPTH_SEQUENCER_H
+#define DEPTH_SEQUENCER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class DepthSequencer {
+public:
+    enum class Result {
+        Apply,      // Continues the sequence: apply it to the book
+        Stale,      // Already covered by the book: ignore
+        Buffered,   // Waiting for a snapshot: kept for replay
+        Gap         // Sequence broken: book is out of date, resync needed
+    };
+
+    // Most messages buffered while waiting for a snapshot; older ones are dropped
+    static constexpr size_t MAX_PENDING = 4096;
+
+    Result onDelta(int64_t fromVersion, int64_t toVersion, std::string_view raw);
+
+    // Call once a snapshot at `version` has been applied to the book. The
+    // buffered messages that follow it are passed to replay(raw) in order.
+    // Returns false if the buffer does not connect to the snapshot (the
+    // snapshot is older than the stream), in which case the caller should
+    // fetch a newer one.
+    template <typename Fn>
+    bool onSnapshot(int64_t version, Fn&& replay) {
+        m_last = version;
+        size_t i = 0;
+        for (; i < m_pendingCount; i++) {
+            const Pending& pending = m_pending[i];
+            if (pending.to <= m_last) continue;
+            if (pending.from > m_last + 1) break;
+            replay(std::string_view(pending.raw));
+            m_last = pending.to;
+        }
+        if (i < m_pendingCount) {
+            dropPending(i);
+            return false;
+        }
+        m_pendingCount = 0;
+        m_live = true;
+        m_resyncs++;
+        return true;
+    }
+
+    // Forgets the sequence; everything is buffered until the next snapshot
+    void reset();
+
+    bool live() const { return m_live; }
+    int64_t lastVersion() const { return m_last; }
+    size_t pendingCount() const { return m_pendingCount; }
+    uint64_t gapCount() const { return m_gaps; }
+    uint64_t resyncCount() const { return m_resyncs; }
+
+private:
+    struct Pending {
+        int64_t from = 0;
+        int64_t to = 0;
+        std::string raw;    // Capacity is reused across resyncs
+    };
+
+    void buffer(int64_t fromVersion, int64_t toVersion, std::string_view raw);
+    void dropPending(size_t count);
+
+    std::vector<Pending> m_pending;
+    size_t m_pendingCount = 0;
+    bool m_live = false;
+    int64_t m_last = 0;
+    uint64_t m_gaps = 0;
+    uint64_t m_resyncs = 0;
+};
+
+#endif //DEPTH_SEQUENCER_H
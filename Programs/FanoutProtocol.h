@@ -0,0 +1,49 @@
+//
+// Wire format of the market data fan-out (MulticastFanout.h).
+//
+// Live updates go out as UDP datagrams to a multicast group, one stream per
+// shard worker ("channel"). A datagram is a FanoutPacketHeader followed by
+// `count` BookRecord; the sequence counts datagrams of its channel from 1,
+// so a receiver that sees a jump lost the updates in between.
+//
+// Recovery is TCP on the same port number: the publisher accepts, writes a
+// FanoutRecoveryHeader, the symbol table and a snapshot (Clear and levels)
+// of every book, then closes. A receiver applies the snapshot and drops live
+// records whose version the snapshot already contains.
+//
+// Everything is in host byte order (little-endian), like BookRecord.
+//
+
+#ifndef FANOUT_PROTOCOL_H
+#define FANOUT_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "BookRecord.h"
+
+constexpr uint32_t FANOUT_PACKET_MAGIC = 0x3146584D;     // "MXF1"
+constexpr uint32_t FANOUT_RECOVERY_MAGIC = 0x3152584D;   // "MXR1"
+
+struct FanoutPacketHeader {
+    uint32_t magic;             // FANOUT_PACKET_MAGIC
+    uint16_t channel;           // Shard worker that produced the records
+    uint16_t count;             // BookRecord that follow
+    uint64_t sequence;          // Datagram count of the channel, from 1
+    int64_t sendNs;             // Sender's steady_clock at send
+};
+static_assert(sizeof(FanoutPacketHeader) == 24, "The header layout is part of the wire format");
+
+// Records per datagram: the whole datagram fits a 1500-byte Ethernet frame
+constexpr size_t FANOUT_MAX_RECORDS = 25;
+constexpr size_t FANOUT_MAX_PACKET = sizeof(FanoutPacketHeader) + FANOUT_MAX_RECORDS * sizeof(BookRecord);
+
+struct FanoutRecoveryHeader {
+    uint32_t magic;             // FANOUT_RECOVERY_MAGIC
+    uint32_t channelCount;
+    uint32_t symbolCount;       // BookSymbolName that follow
+    uint32_t recordCount;       // BookRecord after the names
+};
+static_assert(sizeof(FanoutRecoveryHeader) == 16, "The header layout is part of the wire format");
+
+#endif //FANOUT_PROTOCOL_H
@@ -0,0 +1,200 @@
+//
+// Fixed-point decimal helpers for prices and quantities.
+//
+// A value is stored as raw int64 ticks: value = raw / 10^decimals. The number
+// of decimals is chosen per symbol (see SymbolScale) from the wire text, so
+// comparisons and book keys are exact integer operations and no precision is
+// lost on high priced symbols.
+//
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+
+constexpr int FIXED_MAX_DECIMALS = 12;
+
+constexpr int64_t FIXED_POW10[FIXED_MAX_DECIMALS + 1] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+    100000000LL, 1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL
+};
+
+// Per-symbol scale. Unknown (-1) until the first message of a subscription
+// has been seen. Later values with more decimals widen it (and the book is
+// rescaled with it); it never narrows during a subscription.
+struct SymbolScale {
+    int priceDecimals = -1;
+    int qtyDecimals = -1;
+
+    bool known() const { return priceDecimals >= 0 && qtyDecimals >= 0; }
+    bool operator==(const SymbolScale&) const = default;
+};
+
+// Number of digits after the decimal point in wire text ("3300.120" -> 3).
+// Exponent notation ("1.5e-05") is folded in so doubles printed by the
+// futures feed give the same answer as their plain decimal spelling.
+inline int fixedDecimals(std::string_view text) {
+    int decimals = 0;
+    int exponent = 0;
+    bool fraction = false;
+    size_t i = 0;
+    for (; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '.') {
+            fraction = true;
+        } else if (c >= '0' && c <= '9') {
+            if (fraction) decimals++;
+        } else if (c == 'e' || c == 'E') {
+            break;
+        }
+    }
+    if (i < text.size()) {
+        bool negative = false;
+        i++;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            negative = text[i] == '-';
+            i++;
+        }
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++) {
+            exponent = exponent * 10 + (text[i] - '0');
+        }
+        if (negative) exponent = -exponent;
+    }
+    decimals -= exponent;
+    if (decimals < 0) decimals = 0;
+    if (decimals > FIXED_MAX_DECIMALS) decimals = FIXED_MAX_DECIMALS;
+    return decimals;
+}
+
+// Widens a scale so that the given price/quantity text is represented exactly
+inline void widenScale(SymbolScale& scale, std::string_view price, std::string_view qty) {
+    int priceDecimals = fixedDecimals(price);
+    int qtyDecimals = fixedDecimals(qty);
+    if (priceDecimals > scale.priceDecimals) scale.priceDecimals = priceDecimals;
+    if (qtyDecimals > scale.qtyDecimals) scale.qtyDecimals = qtyDecimals;
+}
+
+// Parses decimal wire text into raw ticks at the given scale. Digits beyond
+// the scale are rounded half-up; `exact`, when given, is cleared if any of
+// them was not zero. Returns false on malformed input or overflow.
+inline bool parseFixed(std::string_view text, int decimals, int64_t& out, bool* exact = nullptr) {
+    if (decimals < 0 || decimals > FIXED_MAX_DECIMALS) return false;
+
+    size_t i = 0;
+    bool negative = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        i++;
+    }
+
+    // Collect significant digits and the position of the decimal point
+    uint64_t mantissa = 0;
+    int fractionDigits = 0;
+    int droppedDigits = 0;     // Integer digits that did not fit the mantissa
+    int firstDropped = -1;     // First digit beyond mantissa precision, for rounding
+    bool fraction = false;
+    bool anyDigit = false;
+    for (; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '.') {
+            if (fraction) return false;
+            fraction = true;
+            continue;
+        }
+        if (c < '0' || c > '9') break;
+        anyDigit = true;
+        if (mantissa < 100000000000000000ULL) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            if (fraction) fractionDigits++;
+        } else {
+            if (firstDropped < 0) firstDropped = c - '0';
+            if (!fraction) droppedDigits++;
+        }
+    }
+    if (!anyDigit) return false;
+
+    int exponent = 0;
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        bool negativeExp = false;
+        i++;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            negativeExp = text[i] == '-';
+            i++;
+        }
+        if (i >= text.size() || text[i] < '0' || text[i] > '9') return false;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; i++) {
+            if (exponent < 1000) exponent = exponent * 10 + (text[i] - '0');
+        }
+        if (negativeExp) exponent = -exponent;
+    }
+    if (i != text.size()) return false;
+
+    // value = mantissa * 10^(shift - decimals); shift the mantissa into ticks
+    int shift = decimals - fractionDigits + droppedDigits + exponent;
+    if (shift >= 0) {
+        if (shift > 18) {
+            if (mantissa != 0) return false;
+            out = 0;
+            return true;
+        }
+        uint64_t scale = 1;
+        for (int s = 0; s < shift; s++) scale *= 10;
+        if (mantissa > static_cast<uint64_t>(INT64_MAX) / scale) return false;
+        mantissa *= scale;
+    } else {
+        int drop = -shift;
+        if (drop > 19) {
+            if (exact && mantissa != 0) *exact = false;
+            mantissa = 0;
+        } else {
+            uint64_t scale = 1;
+            for (int s = 0; s < drop - 1; s++) scale *= 10;
+            if (exact && mantissa % (scale * 10) != 0) *exact = false;
+            uint64_t roundDigit = (mantissa / scale) % 10;
+            mantissa /= scale * 10;
+            if (roundDigit >= 5) mantissa++;
+        }
+    }
+    if (shift == 0 && firstDropped >= 5) mantissa++;
+    if (mantissa > static_cast<uint64_t>(INT64_MAX)) return false;
+
+    out = negative ? -static_cast<int64_t>(mantissa) : static_cast<int64_t>(mantissa);
+    return true;
+}
+
+inline double fixedToDouble(int64_t raw, int decimals) {
+    if (decimals <= 0) return static_cast<double>(raw);
+    return static_cast<double>(raw) / static_cast<double>(FIXED_POW10[decimals]);
+}
+
+// Converts a value from one scale to another, rounding half away from zero
+inline int64_t fixedRescale(int64_t raw, int fromDecimals, int toDecimals) {
+    if (toDecimals >= fromDecimals) return raw * FIXED_POW10[toDecimals - fromDecimals];
+    int64_t div = FIXED_POW10[fromDecimals - toDecimals];
+    int64_t half = div / 2;
+    return raw >= 0 ? (raw + half) / div : -((-raw + half) / div);
+}
+
+// Formats raw ticks as exact decimal text with `shownDecimals` digits after
+// the point (rounded if fewer than the scale). Returns the snprintf result.
+inline int formatFixed(char* buffer, size_t size, int64_t raw, int decimals, int shownDecimals) {
+    if (decimals < 0) decimals = 0;
+    if (shownDecimals < 0) shownDecimals = 0;
+    if (shownDecimals > FIXED_MAX_DECIMALS) shownDecimals = FIXED_MAX_DECIMALS;
+    int64_t value = fixedRescale(raw, decimals, shownDecimals);
+    bool negative = value < 0;
+    uint64_t magnitude = negative ? static_cast<uint64_t>(-value) : static_cast<uint64_t>(value);
+    uint64_t unit = static_cast<uint64_t>(FIXED_POW10[shownDecimals]);
+    if (shownDecimals == 0) {
+        return snprintf(buffer, size, "%s%llu", negative ? "-" : "",
+                        static_cast<unsigned long long>(magnitude));
+    }
+    return snprintf(buffer, size, "%s%llu.%0*llu", negative ? "-" : "",
+                    static_cast<unsigned long long>(magnitude / unit), shownDecimals,
+                    static_cast<unsigned long long>(magnitude % unit));
+}
+
+#endif //FIXED_POINT_H
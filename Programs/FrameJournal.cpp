@@ -0,0 +1,310 @@
+#include "FrameJournal.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+int64_t journalNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static size_t alignRecord(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+// Index of "<prefix>-NNNNNN.jrn", or -1 for any other file name
+static long segmentIndexOf(const std::string& name, const std::string& prefix) {
+    if (name.size() != prefix.size() + 11 || name.compare(0, prefix.size(), prefix) != 0) return -1;
+    if (name[prefix.size()] != '-' || name.compare(name.size() - 4, 4, ".jrn") != 0) return -1;
+    long index = 0;
+    for (size_t i = prefix.size() + 1; i < name.size() - 4; i++) {
+        if (name[i] < '0' || name[i] > '9') return -1;
+        index = index * 10 + (name[i] - '0');
+    }
+    return index;
+}
+
+std::string FrameJournal::segmentPath(const std::string& directory, const std::string& prefix, uint32_t index) {
+    char name[32];
+    snprintf(name, sizeof(name), "-%06u.jrn", index);
+    return (fs::path(directory) / (prefix + name)).string();
+}
+
+FrameJournal::FrameJournal(Options options)
+    : m_options(std::move(options)) {}
+
+FrameJournal::~FrameJournal() {
+    close();
+}
+
+bool FrameJournal::open() {
+    if (isOpen()) return true;
+
+    std::error_code ec;
+    fs::create_directories(m_options.directory, ec);
+    if (ec) {
+        std::cerr << "Journal directory " << m_options.directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    // Continue after whatever an earlier run left behind
+    m_nextIndex = 0;
+    for (const auto& entry : fs::directory_iterator(m_options.directory, ec)) {
+        long index = segmentIndexOf(entry.path().filename().string(), m_options.prefix);
+        if (index >= 0 && static_cast<uint32_t>(index) >= m_nextIndex) m_nextIndex = static_cast<uint32_t>(index) + 1;
+    }
+
+    if (!mapSegment(m_nextIndex++, m_current)) return false;
+    m_segments = 1;
+
+    m_stopping = false;
+    m_spareWanted = true;
+    m_helper = std::thread([this] { helperLoop(); });
+    std::cout << "Journaling frames to " << segmentPath(m_options.directory, m_options.prefix, m_current.index)
+              << std::endl;
+    return true;
+}
+
+void FrameJournal::close() {
+    if (!isOpen()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_retiredCount < MAX_RETIRED) {
+            m_retired[m_retiredCount++] = m_current;
+        } else {
+            releaseSegment(m_current);
+        }
+        m_current = Segment{};
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_helper.joinable()) m_helper.join();
+
+    // The spare never received a frame
+    if (m_spare.data) {
+        std::string path = segmentPath(m_options.directory, m_options.prefix, m_spare.index);
+        m_spare.used = 0;
+        releaseSegment(m_spare);
+        ::unlink(path.c_str());
+        m_spare = Segment{};
+    }
+}
+
+bool FrameJournal::append(std::string_view frame, int64_t recvNs, int64_t exchangeMs, uint16_t stream,
+                          uint16_t flags) {
+    size_t need = sizeof(JournalRecordHeader) + alignRecord(frame.size());
+    if (m_current.used + need > m_current.size) {
+        if (need > m_options.segmentBytes - sizeof(JournalSegmentHeader) || !rotate()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    char* record = m_current.data + m_current.used;
+    JournalRecordHeader header{static_cast<uint32_t>(frame.size()), stream, flags, recvNs, exchangeMs};
+    std::memcpy(record + sizeof(header), frame.data(), frame.size());
+    std::memcpy(record, &header, sizeof(header));
+    m_current.used += need;
+
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    m_bytes.fetch_add(frame.size(), std::memory_order_relaxed);
+    return true;
+}
+
+bool FrameJournal::rotate() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_spare.data || m_retiredCount == MAX_RETIRED) return false;
+
+        m_retired[m_retiredCount++] = m_current;
+        m_current = m_spare;
+        m_spare = Segment{};
+        m_spareWanted = true;
+    }
+    m_wake.notify_one();
+    m_segments.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool FrameJournal::mapSegment(uint32_t index, Segment& out) {
+    std::string path = segmentPath(m_options.directory, m_options.prefix, index);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        std::cerr << "Journal segment " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (::ftruncate(fd, static_cast<off_t>(m_options.segmentBytes)) != 0) {
+        std::cerr << "Journal segment " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;  // Fault the pages in here rather than on the writer's thread
+#endif
+    void* data = ::mmap(nullptr, m_options.segmentBytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "Journal segment " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        ::unlink(path.c_str());
+        return false;
+    }
+
+    JournalSegmentHeader header{};
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = 1;
+    header.segmentIndex = index;
+    header.createdSteadyNs = journalNowNs();
+    header.createdSystemNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::strncpy(header.tag, m_options.tag.c_str(), sizeof(header.tag) - 1);
+    std::memcpy(data, &header, sizeof(header));
+
+    out.fd = fd;
+    out.data = static_cast<char*>(data);
+    out.size = m_options.segmentBytes;
+    out.used = sizeof(header);
+    out.index = index;
+    return true;
+}
+
+// Trims the file to what was written, so the unused tail takes no disk space
+void FrameJournal::releaseSegment(Segment& segment) {
+    if (segment.data) ::munmap(segment.data, segment.size);
+    if (segment.fd >= 0) {
+        if (::ftruncate(segment.fd, static_cast<off_t>(segment.used)) != 0) {
+            std::cerr << "Journal trim failed: " << std::strerror(errno) << std::endl;
+        }
+        ::close(segment.fd);
+    }
+    segment = Segment{};
+}
+
+void FrameJournal::helperLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this] {
+            return m_stopping || m_retiredCount > 0 || (m_spareWanted && !m_spare.data);
+        });
+
+        while (m_retiredCount > 0) {
+            Segment segment = m_retired[--m_retiredCount];
+            lock.unlock();
+            releaseSegment(segment);
+            lock.lock();
+        }
+        if (m_stopping) break;
+
+        if (m_spareWanted && !m_spare.data) {
+            uint32_t index = m_nextIndex++;
+            lock.unlock();
+            Segment spare;
+            bool mapped = mapSegment(index, spare);
+            lock.lock();
+            if (mapped) {
+                m_spare = spare;
+                m_spareWanted = false;
+            } else {
+                // Disk full or similar: frames are dropped until a retry works
+                m_wake.wait_for(lock, std::chrono::seconds(1));
+            }
+        }
+    }
+}
+
+JournalReader::JournalReader(std::string directory, std::string prefix)
+    : m_directory(std::move(directory)),
+      m_prefix(std::move(prefix)) {
+    // Start at the oldest segment present
+    long first = -1;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(m_directory, ec)) {
+        long index = segmentIndexOf(entry.path().filename().string(), m_prefix);
+        if (index >= 0 && (first < 0 || index < first)) first = index;
+    }
+    m_index = first < 0 ? 0 : static_cast<uint32_t>(first);
+}
+
+JournalReader::~JournalReader() {
+    closeSegment();
+}
+
+const JournalSegmentHeader* JournalReader::segmentHeader() const {
+    return m_data ? reinterpret_cast<const JournalSegmentHeader*>(m_data) : nullptr;
+}
+
+bool JournalReader::openSegment() {
+    std::string path = FrameJournal::segmentPath(m_directory, m_prefix, m_index);
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(JournalSegmentHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+
+    if (std::memcmp(data, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        std::cerr << path << " is not a frame journal" << std::endl;
+        ::munmap(data, static_cast<size_t>(st.st_size));
+        return false;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    ::madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(st.st_size);
+    m_offset = sizeof(JournalSegmentHeader);
+    m_segmentsRead++;
+    return true;
+}
+
+void JournalReader::closeSegment() {
+    if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_offset = 0;
+}
+
+bool JournalReader::next(Frame& frame) {
+    for (;;) {
+        if (!m_data) {
+            if (m_started) m_index++;
+            m_started = true;
+            if (!openSegment()) return false;
+        }
+
+        if (m_offset + sizeof(JournalRecordHeader) <= m_size) {
+            JournalRecordHeader header;
+            std::memcpy(&header, m_data + m_offset, sizeof(header));
+            size_t end = m_offset + sizeof(header) + header.size;
+            if (header.size != 0 && end <= m_size) {
+                frame.text = std::string_view(m_data + m_offset + sizeof(header), header.size);
+                frame.stream = header.stream;
+                frame.flags = header.flags;
+                frame.recvNs = header.recvNs;
+                frame.exchangeMs = header.exchangeMs;
+                m_offset += sizeof(header) + alignRecord(header.size);
+                return true;
+            }
+        }
+        closeSegment();
+    }
+}
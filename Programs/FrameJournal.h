@@ -0,0 +1,169 @@
+//
+// Append-only capture of raw websocket frames.
+//
+// Frames go into memory-mapped segment files of a fixed size. Appending is
+// a memcpy into the mapping plus a few stores, with no allocation and no
+// system call; a helper thread maps (and pre-faults) the next segment ahead
+// of time and trims, unmaps and closes the finished ones, so rotating only
+// swaps pointers on the caller's thread.
+//
+// Segment layout:
+//   JournalSegmentHeader (64 bytes)
+//   records, each JournalRecordHeader followed by the frame text, padded to 8 bytes
+//   a record header with size 0 marks the end (a trimmed file may just end)
+//
+// Besides frames, a record flagged JOURNAL_RESET marks a symbol's stream
+// (re)starting on a connection; its text is the symbol. Replays drop the
+// symbol's book there, as the live feed does.
+//
+// Receive times come from steady_clock in nanoseconds. Each segment header
+// stores a steady/system clock pair taken when it was created so the times
+// can be placed on the wall clock.
+//
+
+#ifndef FRAME_JOURNAL_H
+#define FRAME_JOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+constexpr char JOURNAL_MAGIC[8] = {'M', 'E', 'X', 'C', 'J', 'R', 'N', '1'};
+
+struct JournalSegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t segmentIndex;
+    int64_t createdSteadyNs;    // steady_clock and system_clock read together
+    int64_t createdSystemNs;
+    char tag[32];               // Free text, e.g. "spot" / "futures"
+};
+static_assert(sizeof(JournalSegmentHeader) == 64, "Segment header is 64 bytes on disk");
+
+// JournalRecordHeader::flags
+constexpr uint16_t JOURNAL_RESET = 1;   // Not a frame: the symbol's stream (re)started
+
+struct JournalRecordHeader {
+    uint32_t size;              // Frame bytes; 0 ends the segment
+    uint16_t stream;            // Connection the frame arrived on
+    uint16_t flags;             // JOURNAL_* bits, 0 for a frame
+    int64_t recvNs;             // steady_clock when the frame was read
+    int64_t exchangeMs;         // Exchange time from the frame, 0 if it had none
+};
+static_assert(sizeof(JournalRecordHeader) == 24, "Record header is 24 bytes on disk");
+
+// Steady clock in nanoseconds, the time base of recvNs
+int64_t journalNowNs();
+
+class FrameJournal {
+public:
+    struct Options {
+        std::string directory;
+        std::string prefix = "frames";
+        std::string tag;
+        size_t segmentBytes = size_t(256) << 20;
+    };
+
+    explicit FrameJournal(Options options);
+    ~FrameJournal();
+
+    FrameJournal(const FrameJournal&) = delete;
+    FrameJournal& operator=(const FrameJournal&) = delete;
+
+    // Creates the directory and maps the first segment. Segments already in
+    // the directory are not overwritten; numbering continues after them.
+    bool open();
+    // Finishes the current segment and waits for the helper to release it
+    void close();
+    bool isOpen() const { return m_current.data != nullptr; }
+
+    // Single writer. Returns false if the frame was dropped: larger than a
+    // segment, or the next segment is not mapped yet.
+    bool append(std::string_view frame, int64_t recvNs, int64_t exchangeMs, uint16_t stream = 0,
+                uint16_t flags = 0);
+
+    uint64_t frameCount() const { return m_frames.load(std::memory_order_relaxed); }
+    uint64_t byteCount() const { return m_bytes.load(std::memory_order_relaxed); }
+    uint64_t droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    uint32_t segmentCount() const { return m_segments.load(std::memory_order_relaxed); }
+
+    static std::string segmentPath(const std::string& directory, const std::string& prefix, uint32_t index);
+
+private:
+    struct Segment {
+        int fd = -1;
+        char* data = nullptr;
+        size_t size = 0;
+        size_t used = 0;
+        uint32_t index = 0;
+    };
+
+    bool mapSegment(uint32_t index, Segment& out);
+    static void releaseSegment(Segment& segment);
+    bool rotate();
+    void helperLoop();
+
+    Options m_options;
+    Segment m_current;
+    uint32_t m_nextIndex = 0;
+
+    // Hand-off with the helper thread; the writer only takes the lock to rotate
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    Segment m_spare;                        // Mapped ahead by the helper
+    bool m_spareWanted = false;
+    static constexpr size_t MAX_RETIRED = 4;
+    Segment m_retired[MAX_RETIRED];         // Finished, waiting to be trimmed and unmapped
+    size_t m_retiredCount = 0;
+    bool m_stopping = false;
+    std::thread m_helper;
+
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint64_t> m_bytes{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint32_t> m_segments{0};
+};
+
+// Reads the frames of a journal back in order, segment after segment
+class JournalReader {
+public:
+    struct Frame {
+        std::string_view text;      // Valid until the next call to next()
+        uint16_t stream = 0;
+        uint16_t flags = 0;
+        int64_t recvNs = 0;
+        int64_t exchangeMs = 0;
+    };
+
+    JournalReader(std::string directory, std::string prefix = "frames");
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Returns false once every segment has been read
+    bool next(Frame& frame);
+
+    uint32_t segmentsRead() const { return m_segmentsRead; }
+    const JournalSegmentHeader* segmentHeader() const;
+
+private:
+    bool openSegment();
+    void closeSegment();
+
+    std::string m_directory;
+    std::string m_prefix;
+    uint32_t m_index = 0;
+    uint32_t m_segmentsRead = 0;
+    bool m_started = false;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+};
+
+#endif //FRAME_JOURNAL_H
@@ -0,0 +1,197 @@
+#include "Indicators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+RollingWindow::RollingWindow(int64_t windowNs, size_t buckets)
+    : m_buckets(buckets ? buckets : 1),
+      m_bucketNs(std::max<int64_t>(windowNs / static_cast<int64_t>(buckets ? buckets : 1), 1)) {}
+
+void RollingWindow::advance(int64_t tNs) {
+    int64_t bucket = tNs / m_bucketNs;
+    if (m_current == INT64_MIN) {
+        m_current = bucket;
+        return;
+    }
+    if (bucket <= m_current) return;
+
+    // Empty the buckets between the newest one and tNs
+    const int64_t size = static_cast<int64_t>(m_buckets.size());
+    int64_t expire = std::min(bucket - m_current, size);
+    for (int64_t k = 1; k <= expire; k++) {
+        m_buckets[static_cast<size_t>((m_current + k) % size)] = Bucket{};
+    }
+    m_current = bucket;
+    retotal();
+}
+
+void RollingWindow::retotal() {
+    // Summing afresh once per bucket keeps rounding from building up
+    const size_t size = m_buckets.size();
+    m_total = Bucket{};
+    m_first = 0;
+    for (size_t k = 1; k <= size; k++) {
+        const Bucket& bucket = m_buckets[static_cast<size_t>((m_current + static_cast<int64_t>(k)) % static_cast<int64_t>(size))];
+        if (bucket.count && !m_total.count) m_first = bucket.first;
+        m_total.count += bucket.count;
+        m_total.sum += bucket.sum;
+        m_total.weighted += bucket.weighted;
+        m_total.weight += bucket.weight;
+        m_total.timed += bucket.timed;
+        m_total.timeNs += bucket.timeNs;
+    }
+}
+
+void RollingWindow::add(int64_t tNs, double value, double weight) {
+    advance(tNs);
+    Bucket& bucket = m_buckets[static_cast<size_t>(m_current % static_cast<int64_t>(m_buckets.size()))];
+    if (!bucket.count) bucket.first = value;
+    if (!m_total.count) m_first = value;
+
+    bucket.count++;
+    bucket.sum += value;
+    bucket.weighted += value * weight;
+    bucket.weight += weight;
+    m_total.count++;
+    m_total.sum += value;
+    m_total.weighted += value * weight;
+    m_total.weight += weight;
+}
+
+void RollingWindow::addDuration(int64_t tNs, double value, int64_t durationNs) {
+    advance(tNs);
+    Bucket& bucket = m_buckets[static_cast<size_t>(m_current % static_cast<int64_t>(m_buckets.size()))];
+    double timed = value * static_cast<double>(durationNs);
+    bucket.timed += timed;
+    bucket.timeNs += static_cast<double>(durationNs);
+    m_total.timed += timed;
+    m_total.timeNs += static_cast<double>(durationNs);
+}
+
+void RollingWindow::reset() {
+    std::fill(m_buckets.begin(), m_buckets.end(), Bucket{});
+    m_current = INT64_MIN;
+    m_total = Bucket{};
+    m_first = 0;
+}
+
+TrendTracker::TrendTracker(int64_t shortWindowNs, int64_t longWindowNs, size_t buckets)
+    : m_short(shortWindowNs, buckets),
+      m_long(longWindowNs, buckets),
+      m_trades(longWindowNs, buckets),
+      m_shortNs(shortWindowNs),
+      m_longNs(longWindowNs) {}
+
+void TrendTracker::onMid(int64_t tNs, double mid) {
+    if (m_lastNs == 0) {
+        m_emaFast = m_emaSlow = mid;
+    } else {
+        // The previous mid held until now; after a long pause only the window counts
+        int64_t heldNs = std::clamp<int64_t>(tNs - m_lastNs, 0, m_longNs);
+        m_long.addDuration(tNs, m_lastMid, heldNs);
+
+        // Decay by elapsed time, so irregular events weigh in by how long they lasted
+        double dt = static_cast<double>(heldNs);
+        m_emaFast += (1.0 - std::exp(-dt / static_cast<double>(m_shortNs))) * (mid - m_emaFast);
+        m_emaSlow += (1.0 - std::exp(-dt / static_cast<double>(m_longNs))) * (mid - m_emaSlow);
+    }
+    m_lastNs = tNs;
+    m_lastMid = mid;
+
+    m_short.add(tNs, mid);
+    m_long.add(tNs, mid);
+    m_trades.advance(tNs);
+
+    double start = m_short.first();
+    m_values.shortTermMA = static_cast<float>(m_short.mean());
+    m_values.longTermMA = static_cast<float>(m_long.mean());
+    m_values.emaFast = static_cast<float>(m_emaFast);
+    m_values.emaSlow = static_cast<float>(m_emaSlow);
+    m_values.momentum = start > 0 ? static_cast<float>((mid - start) / start) : 0.0f;
+    double twap = m_long.timeWeightedMean();
+    m_values.twap = static_cast<float>(twap > 0 ? twap : mid);
+    m_values.vwap = static_cast<float>(m_trades.weightedMean());
+}
+
+void TrendTracker::onTrade(int64_t tNs, double price, double qty) {
+    m_trades.add(tNs, price, qty);
+    m_values.vwap = static_cast<float>(m_trades.weightedMean());
+}
+
+void TrendTracker::reset() {
+    m_short.reset();
+    m_long.reset();
+    m_trades.reset();
+    m_lastNs = 0;
+    m_lastMid = 0;
+    m_emaFast = m_emaSlow = 0;
+    m_values = {};
+}
+
+OrderFlowTracker::OrderFlowTracker(int64_t bucketNs) : m_bucketNs(std::max<int64_t>(bucketNs, 1)) {}
+
+bool OrderFlowTracker::advance(int64_t tNs) {
+    int64_t bucket = tNs / m_bucketNs;
+    if (m_current == INT64_MIN) {
+        m_current = bucket;
+        m_values.newest = static_cast<uint32_t>(bucket % static_cast<int64_t>(OrderFlow::HISTORY));
+        return false;
+    }
+    if (bucket <= m_current) return false;
+
+    // Empty the buckets between the newest one and tNs
+    const int64_t size = static_cast<int64_t>(OrderFlow::HISTORY);
+    int64_t expire = std::min(bucket - m_current, size);
+    for (int64_t k = 1; k <= expire; k++) {
+        size_t slot = static_cast<size_t>((m_current + k) % size);
+        m_buckets[slot] = Bucket{};
+        m_values.history[slot] = 0;
+    }
+    m_current = bucket;
+    m_values.newest = static_cast<uint32_t>(bucket % size);
+    retotal();
+    return true;
+}
+
+void OrderFlowTracker::retotal() {
+    // Summing afresh once per bucket keeps rounding from building up
+    m_total = Bucket{};
+    for (const Bucket& bucket : m_buckets) {
+        m_total.buy += bucket.buy;
+        m_total.sell += bucket.sell;
+        m_total.trades += bucket.trades;
+    }
+    publishTotals();
+}
+
+void OrderFlowTracker::onTrades(int64_t tNs, double buyVolume, double sellVolume, uint32_t trades) {
+    advance(tNs);
+    size_t slot = m_values.newest;
+    Bucket& bucket = m_buckets[slot];
+    bucket.buy += buyVolume;
+    bucket.sell += sellVolume;
+    bucket.trades += trades;
+    m_total.buy += buyVolume;
+    m_total.sell += sellVolume;
+    m_total.trades += trades;
+
+    m_values.cumulativeDelta += buyVolume - sellVolume;
+    m_values.history[slot] = static_cast<float>(bucket.buy - bucket.sell);
+    publishTotals();
+}
+
+void OrderFlowTracker::publishTotals() {
+    double volume = m_total.buy + m_total.sell;
+    m_values.buyVolume = static_cast<float>(m_total.buy);
+    m_values.sellVolume = static_cast<float>(m_total.sell);
+    m_values.imbalance = volume > 0 ? static_cast<float>((m_total.buy - m_total.sell) / volume) : 0.0f;
+    m_values.trades = m_total.trades;
+}
+
+void OrderFlowTracker::reset() {
+    std::fill(std::begin(m_buckets), std::end(m_buckets), Bucket{});
+    m_current = INT64_MIN;
+    m_total = Bucket{};
+    m_values = {};
+}
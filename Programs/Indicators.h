@@ -0,0 +1,150 @@
+//
+// Rolling trend and order flow indicators over time windows.
+//
+// A window is a ring of equal time buckets. An update adds to the current
+// bucket and its running sums; moving into a new bucket expires the oldest
+// and re-totals the ring, which happens once per bucket width however many
+// events arrive. Updates are O(1), nothing allocates after construction, and
+// the values depend on the time of each book event, not on how often the
+// window is drawn.
+//
+
+#ifndef INDICATORS_H
+#define INDICATORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Trend of one symbol as of its latest book event; trivially copyable so it
+// travels inside BookSnapshot. Zero until there is data.
+struct PriceTrend {
+    float shortTermMA;  // Mean mid over the short window
+    float longTermMA;   // Mean mid over the long window
+    float emaFast;      // Exponential mid, time constant = short window
+    float emaSlow;      // Exponential mid, time constant = long window
+    float momentum;     // Relative change of the mid across the short window
+    float twap;         // Time weighted mid over the long window
+    float vwap;         // Volume weighted trade price over the long window
+};
+
+class RollingWindow {
+public:
+    RollingWindow(int64_t windowNs, size_t buckets);
+
+    // A sample at tNs; weight is the volume for VWAP style means
+    void add(int64_t tNs, double value, double weight = 1.0);
+
+    // value held for durationNs ending at tNs, for time weighted means
+    void addDuration(int64_t tNs, double value, int64_t durationNs);
+
+    // Moves the window to tNs, expiring buckets that fell out of it
+    void advance(int64_t tNs);
+    void reset();
+
+    size_t count() const { return m_total.count; }
+    double mean() const { return m_total.count ? m_total.sum / m_total.count : 0.0; }
+    double weightedMean() const { return m_total.weight > 0 ? m_total.weighted / m_total.weight : 0.0; }
+    double timeWeightedMean() const { return m_total.timeNs > 0 ? m_total.timed / m_total.timeNs : 0.0; }
+    // First sample still in the window, 0 when empty
+    double first() const { return m_total.count ? m_first : 0.0; }
+
+private:
+    struct Bucket {
+        size_t count = 0;
+        double sum = 0;         // Plain samples
+        double weighted = 0;    // value * weight
+        double weight = 0;
+        double timed = 0;       // value * ns held
+        double timeNs = 0;
+        double first = 0;       // First sample of the bucket
+    };
+
+    void retotal();
+
+    std::vector<Bucket> m_buckets;
+    int64_t m_bucketNs;
+    int64_t m_current = INT64_MIN;  // Bucket number (tNs / bucket width) of the newest bucket
+    Bucket m_total;                 // Sum of every live bucket
+    double m_first = 0;
+};
+
+// Taker flow of one symbol as of its latest trades; trivially copyable so it
+// travels through a Seqlock. Volumes are in base units (contracts on
+// futures). Zero until there is data.
+struct OrderFlow {
+    static constexpr size_t HISTORY = 60;   // Buckets of history, and of the window
+
+    double cumulativeDelta;     // Taker buys minus taker sells since the symbol was added
+    float buyVolume;            // Taker buys over the window
+    float sellVolume;           // Taker sells over the window
+    float imbalance;            // (buy - sell) / (buy + sell) over the window
+    uint32_t trades;            // Trades over the window
+    uint32_t newest;            // Slot of the newest bucket in history
+    float history[HISTORY];     // Net flow (buys - sells) per bucket, a ring ending at newest
+
+    // Net flow of the i-th bucket, oldest first
+    float historyAt(size_t i) const { return history[(newest + 1 + i) % HISTORY]; }
+};
+
+// Cumulative volume delta and windowed buy/sell flow of one symbol, fed with
+// the trades of each deals frame at once. The buckets are a fixed array, so
+// nothing allocates even at construction; like RollingWindow, the totals are
+// re-summed once per bucket, not per trade.
+class OrderFlowTracker {
+public:
+    explicit OrderFlowTracker(int64_t bucketNs = 1'000'000'000);
+
+    // The trades of one frame: taker buy and sell volume at tNs
+    void onTrades(int64_t tNs, double buyVolume, double sellVolume, uint32_t trades);
+    // Moves the window to tNs; true when buckets expired and the values changed
+    bool advance(int64_t tNs);
+    void reset();
+
+    const OrderFlow& values() const { return m_values; }
+
+private:
+    struct Bucket {
+        double buy = 0;
+        double sell = 0;
+        uint32_t trades = 0;
+    };
+
+    void retotal();
+    void publishTotals();
+
+    Bucket m_buckets[OrderFlow::HISTORY];
+    int64_t m_bucketNs;
+    int64_t m_current = INT64_MIN;  // Bucket number (tNs / bucket width) of the newest bucket
+    Bucket m_total;                 // Sum of every live bucket
+    OrderFlow m_values = {};
+};
+
+// Mid price indicators of one symbol, fed from its book events
+class TrendTracker {
+public:
+    explicit TrendTracker(int64_t shortWindowNs = 10'000'000'000, int64_t longWindowNs = 60'000'000'000,
+                          size_t buckets = 60);
+
+    // The mid price after a book change; tNs on the steady clock
+    void onMid(int64_t tNs, double mid);
+    // A trade print, for the VWAP
+    void onTrade(int64_t tNs, double price, double qty);
+    void reset();
+
+    const PriceTrend& values() const { return m_values; }
+
+private:
+    RollingWindow m_short;
+    RollingWindow m_long;
+    RollingWindow m_trades;
+    int64_t m_shortNs;
+    int64_t m_longNs;
+    int64_t m_lastNs = 0;
+    double m_lastMid = 0;
+    double m_emaFast = 0;
+    double m_emaSlow = 0;
+    PriceTrend m_values = {};
+};
+
+#endif //INDICATORS_H
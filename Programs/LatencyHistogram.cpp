@@ -0,0 +1,113 @@
+#include "LatencyHistogram.h"
+
+#include <bit>
+#include <cmath>
+#include <cstdio>
+
+int64_t steadyToSystemNs(int64_t steadyNs) {
+    static const int64_t offset = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count() - steadyNowNs();
+    return steadyNs + offset;
+}
+
+size_t LatencyHistogram::indexOf(uint64_t ns) {
+    if (ns < LINEAR) return static_cast<size_t>(ns);
+    int magnitude = std::bit_width(ns) - 1;     // >= SUB_BITS + 1
+    if (magnitude > MAX_MAGNITUDE) return BUCKETS - 1;
+    uint64_t sub = ns >> (magnitude - SUB_BITS); // In [128, 256)
+    return LINEAR + static_cast<size_t>(magnitude - SUB_BITS - 1) * (size_t(1) << SUB_BITS) +
+           static_cast<size_t>(sub - (uint64_t(1) << SUB_BITS));
+}
+
+int64_t LatencyHistogram::upperOf(size_t index) {
+    if (index < LINEAR) return static_cast<int64_t>(index);
+    size_t k = index - LINEAR;
+    int magnitude = SUB_BITS + 1 + static_cast<int>(k >> SUB_BITS);
+    uint64_t sub = (uint64_t(1) << SUB_BITS) + (k & ((size_t(1) << SUB_BITS) - 1));
+    return static_cast<int64_t>(((sub + 1) << (magnitude - SUB_BITS)) - 1);
+}
+
+void LatencyHistogram::record(int64_t ns) {
+    if (ns < 0) ns = 0;     // Clock skew against the exchange
+    m_buckets[indexOf(static_cast<uint64_t>(ns))].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t max = m_max.load(std::memory_order_relaxed);
+    while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::percentiles(const double* ps, int64_t* out, size_t n) const {
+    uint64_t total = count();
+    int64_t max = this->max();
+    size_t next = 0;
+    if (total == 0) {
+        for (; next < n; next++) out[next] = 0;
+        return;
+    }
+
+    uint64_t seen = 0;
+    for (size_t index = 0; index < BUCKETS && next < n; index++) {
+        seen += m_buckets[index].load(std::memory_order_relaxed);
+        while (next < n) {
+            auto rank = static_cast<uint64_t>(std::ceil(ps[next] / 100.0 * static_cast<double>(total)));
+            if (rank == 0) rank = 1;
+            if (seen < rank) break;
+            int64_t value = upperOf(index);
+            out[next++] = value < max ? value : max;
+        }
+    }
+    // Buckets counted after `total` was read
+    for (; next < n; next++) out[next] = max;
+}
+
+int64_t LatencyHistogram::percentile(double p) const {
+    int64_t value = 0;
+    percentiles(&p, &value, 1);
+    return value;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+const char* LatencyStats::stageName(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::Network: return "network";
+        case LatencyStage::Queue: return "queue";
+        case LatencyStage::Parse: return "parse";
+        case LatencyStage::Apply: return "apply";
+        case LatencyStage::Present: return "present";
+        default: return "?";
+    }
+}
+
+int formatLatency(char* buffer, size_t size, int64_t ns) {
+    if (ns < 1000) return snprintf(buffer, size, "%lldns", static_cast<long long>(ns));
+    if (ns < 1000000) return snprintf(buffer, size, "%.1fus", static_cast<double>(ns) / 1e3);
+    if (ns < 1000000000) return snprintf(buffer, size, "%.2fms", static_cast<double>(ns) / 1e6);
+    return snprintf(buffer, size, "%.2fs", static_cast<double>(ns) / 1e9);
+}
+
+void LatencyStats::dump(std::ostream& out) const {
+    static constexpr double PERCENTILES[] = {50, 99, 99.9};
+    char line[160];
+    snprintf(line, sizeof(line), "%-8s %10s %9s %9s %9s %9s", "stage", "count", "p50", "p99", "p99.9", "max");
+    out << line << '\n';
+    for (size_t i = 0; i < STAGES; i++) {
+        const LatencyHistogram& histogram = m_stages[i];
+        int64_t values[3];
+        histogram.percentiles(PERCENTILES, values, 3);
+
+        char text[4][24];
+        formatLatency(text[0], sizeof(text[0]), values[0]);
+        formatLatency(text[1], sizeof(text[1]), values[1]);
+        formatLatency(text[2], sizeof(text[2]), values[2]);
+        formatLatency(text[3], sizeof(text[3]), histogram.max());
+        snprintf(line, sizeof(line), "%-8s %10llu %9s %9s %9s %9s", stageName(static_cast<LatencyStage>(i)),
+                 static_cast<unsigned long long>(histogram.count()), text[0], text[1], text[2], text[3]);
+        out << line << '\n';
+    }
+    out.flush();
+}
@@ -0,0 +1,87 @@
+//
+// Lock-free latency histograms for the stages a frame goes through.
+//
+// LatencyHistogram is log-linear in the style of HdrHistogram: values below
+// 256 ns get a bucket each, above that every power of two is split into 128
+// buckets, so a reported value is within 0.8% of the recorded one. Buckets
+// are relaxed atomic counters; any number of threads may record while
+// another reads percentiles, with no locks and no allocation.
+//
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+// Steady clock in nanoseconds; the time base of every stage stamp
+inline int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Places a steady stamp on the system clock (offset taken once per process),
+// for comparison with exchange timestamps
+int64_t steadyToSystemNs(int64_t steadyNs);
+
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BITS = 7;                      // 128 buckets per power of two
+    static constexpr int MAX_MAGNITUDE = 40;                // Values clamp at 2^41 ns (~36 min)
+    static constexpr size_t LINEAR = size_t(2) << SUB_BITS; // 256 exact buckets
+    static constexpr size_t BUCKETS = LINEAR + (MAX_MAGNITUDE - SUB_BITS) * (size_t(1) << SUB_BITS);
+
+    void record(int64_t ns);
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    int64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+    // Fills out[i] with the value at percentile ps[i] (ascending, 0..100) in
+    // one pass over the buckets. Values are bucket upper bounds, capped at max().
+    void percentiles(const double* ps, int64_t* out, size_t n) const;
+    int64_t percentile(double p) const;
+
+    // Not atomic with respect to concurrent record() calls
+    void reset();
+
+private:
+    static size_t indexOf(uint64_t ns);
+    static int64_t upperOf(size_t index);
+
+    std::atomic<uint64_t> m_buckets[BUCKETS] = {};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<int64_t> m_max{0};
+};
+
+enum class LatencyStage : uint8_t {
+    Network,    // Exchange timestamp to socket receive (millisecond resolution)
+    Queue,      // Receive to the shard worker picking the frame up
+    Parse,      // Parsing the frame
+    Apply,      // Sequencing and applying it to the book
+    Present,    // Receive to the first presented frame showing the book
+    Count
+};
+
+class LatencyStats {
+public:
+    static constexpr size_t STAGES = static_cast<size_t>(LatencyStage::Count);
+
+    void record(LatencyStage stage, int64_t ns) { m_stages[static_cast<size_t>(stage)].record(ns); }
+    const LatencyHistogram& operator[](LatencyStage stage) const { return m_stages[static_cast<size_t>(stage)]; }
+
+    static const char* stageName(LatencyStage stage);
+
+    // One line per stage: count, p50, p99, p99.9 and max
+    void dump(std::ostream& out) const;
+
+private:
+    LatencyHistogram m_stages[STAGES];
+};
+
+// "812ns", "35.2us", "4.61ms", "2.03s"
+int formatLatency(char* buffer, size_t size, int64_t ns);
+
+#endif //LATENCY_HISTOGRAM_H
@@ -0,0 +1,42 @@
+#include "LineBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <rlgl.h>
+
+void LineBatch::addLine(Vector2 start, Vector2 end, float thickness, Color color) {
+    float dx = end.x - start.x;
+    float dy = end.y - start.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length <= 0 || thickness <= 0) return;
+
+    // Half the thickness along the normal on each side
+    float nx = -dy / length * thickness / 2;
+    float ny = dx / length * thickness / 2;
+
+    Vertex a = {start.x + nx, start.y + ny, color};
+    Vertex b = {start.x - nx, start.y - ny, color};
+    Vertex c = {end.x + nx, end.y + ny, color};
+    Vertex d = {end.x - nx, end.y - ny, color};
+    // Counter-clockwise on screen, as rlgl culls the other winding
+    m_vertices.insert(m_vertices.end(), {b, a, c, c, d, b});
+}
+
+void LineBatch::draw() const {
+    // Whole triangles per chunk, small enough for the default rlgl batch
+    const size_t CHUNK = 3 * 2048;
+
+    rlSetTexture(0);
+    for (size_t begin = 0; begin < m_vertices.size(); begin += CHUNK) {
+        size_t end = std::min(begin + CHUNK, m_vertices.size());
+        rlCheckRenderBatchLimit(static_cast<int>(end - begin));
+
+        rlBegin(RL_TRIANGLES);
+        for (size_t i = begin; i < end; i++) {
+            const Vertex& vertex = m_vertices[i];
+            rlColor4ub(vertex.color.r, vertex.color.g, vertex.color.b, vertex.color.a);
+            rlVertex2f(vertex.x, vertex.y);
+        }
+        rlEnd();
+    }
+}
@@ -0,0 +1,37 @@
+//
+// Line segments collected into one triangle list and drawn in a single batch.
+//
+// DrawLineEx costs a draw command per segment, so a chart of a few hundred
+// points with a glow is thousands of commands a frame. A LineBatch builds the
+// same quads once, with the color in each vertex, keeps them until the data
+// changes, and submits them all between one rlBegin/rlEnd pair.
+//
+
+#ifndef LINE_BATCH_H
+#define LINE_BATCH_H
+
+#include <cstddef>
+#include <vector>
+#include <raylib.h>
+
+class LineBatch {
+public:
+    void clear() { m_vertices.clear(); }
+    bool empty() const { return m_vertices.empty(); }
+    size_t vertexCount() const { return m_vertices.size(); }
+
+    // A segment as a quad `thickness` wide, like DrawLineEx
+    void addLine(Vector2 start, Vector2 end, float thickness, Color color);
+
+    void draw() const;
+
+private:
+    struct Vertex {
+        float x, y;
+        Color color;
+    };
+
+    std::vector<Vertex> m_vertices;     // Two triangles per segment; capacity is kept across rebuilds
+};
+
+#endif //LINE_BATCH_H
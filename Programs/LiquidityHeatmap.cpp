@@ -0,0 +1,216 @@
+#include "LiquidityHeatmap.h"
+#include "FixedPoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static constexpr Color BACKGROUND = {8, 8, 14, 255};
+static constexpr Color BID_LOW = {0, 0, 40, 255};
+static constexpr Color BID_HIGH = {40, 140, 255, 255};
+static constexpr Color ASK_LOW = {40, 0, 0, 255};
+static constexpr Color ASK_HIGH = {255, 90, 60, 255};
+static constexpr Color BEST_BID = {170, 225, 255, 255};
+static constexpr Color BEST_ASK = {255, 205, 170, 255};
+
+// Full-intensity volume loses 0.2% a column, so a wall that left dims out
+// of the scale in about half a minute
+static constexpr double SCALE_DECAY = 0.998;
+
+static Color mix(Color low, Color high, float t) {
+    return {
+        static_cast<unsigned char>(low.r + (high.r - low.r) * t),
+        static_cast<unsigned char>(low.g + (high.g - low.g) * t),
+        static_cast<unsigned char>(low.b + (high.b - low.b) * t),
+        255
+    };
+}
+
+LiquidityHeatmap::LiquidityHeatmap()
+    : m_pixels(static_cast<size_t>(ROWS) * COLUMNS, BACKGROUND),
+      m_column(ROWS, BACKGROUND),
+      m_qty(ROWS, 0),
+      m_upload(ROWS, BACKGROUND) {}
+
+void LiquidityHeatmap::reset() {
+    std::fill(m_pixels.begin(), m_pixels.end(), BACKGROUND);
+    std::fill(m_column.begin(), m_column.end(), BACKGROUND);
+    m_fullUpload = true;
+    m_head = -1;
+    m_filled = 0;
+    m_priceDecimals = -1;
+    m_qtyDecimals = -1;
+    m_version = 0;
+    m_scale = 0;
+}
+
+void LiquidityHeatmap::unload() {
+    if (m_textureLoaded) UnloadTexture(m_texture);
+    m_textureLoaded = false;
+}
+
+void LiquidityHeatmap::ensureTexture() {
+    if (!m_textureLoaded) {
+        Image image = {m_pixels.data(), COLUMNS, ROWS, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        m_texture = LoadTextureFromImage(image);
+        SetTextureFilter(m_texture, TEXTURE_FILTER_POINT);
+        m_textureLoaded = true;
+        m_fullUpload = false;
+    } else if (m_fullUpload) {
+        UpdateTexture(m_texture, m_pixels.data());
+        m_fullUpload = false;
+    }
+}
+
+void LiquidityHeatmap::writeColumn(int column, const Color* pixels) {
+    for (int row = 0; row < ROWS; row++) m_pixels[static_cast<size_t>(row) * COLUMNS + column] = pixels[row];
+
+    // A whole upload (first use, recentring) carries this column too
+    if (!m_textureLoaded || m_fullUpload) {
+        ensureTexture();
+        return;
+    }
+    std::copy_n(pixels, ROWS, m_upload.data());
+    UpdateTextureRec(m_texture, {static_cast<float>(column), 0, 1, static_cast<float>(ROWS)}, m_upload.data());
+}
+
+bool LiquidityHeatmap::beginColumn(double now, uint64_t version, int priceDecimals, int qtyDecimals,
+                                   int64_t bestBid, int64_t bestAsk) {
+    if (priceDecimals != m_priceDecimals || qtyDecimals != m_qtyDecimals) {
+        reset();
+        m_priceDecimals = priceDecimals;
+        m_qtyDecimals = qtyDecimals;
+    }
+
+    auto bucket = static_cast<int64_t>(now / COLUMN_SECONDS);
+    bool sameBook = m_head >= 0 && version == m_version;
+    if (m_head < 0) {
+        m_head = 0;
+        m_filled = 1;
+        m_bucket = bucket;
+        recenter((bestBid + bestAsk) / 2);
+    } else if (bucket > m_bucket) {
+        // Buckets without an update show the book as it was
+        int64_t steps = std::min<int64_t>(bucket - m_bucket, COLUMNS);
+        for (int64_t step = 1; step <= steps; step++) {
+            m_head = (m_head + 1) % COLUMNS;
+            m_filled = std::min(m_filled + 1, COLUMNS);
+            m_scale *= SCALE_DECAY;
+            if (step < steps || sameBook) writeColumn(m_head, m_column.data());
+        }
+        m_bucket = bucket;
+    }
+    if (sameBook) return false;
+
+    m_version = version;
+    m_bestBid = bestBid;
+    m_bestAsk = bestAsk;
+    m_midTick = (bestBid + bestAsk) / 2;
+    int64_t midRow = m_topTick - m_midTick;
+    if (midRow < ROWS / 4 || midRow > ROWS * 3 / 4) recenter(m_midTick);
+
+    std::fill(m_qty.begin(), m_qty.end(), 0);
+    return true;
+}
+
+void LiquidityHeatmap::plot(int64_t price, int64_t qty) {
+    int64_t row = m_topTick - price;
+    if (row >= 0 && row < ROWS) m_qty[row] = qty;
+}
+
+void LiquidityHeatmap::endColumn() {
+    int64_t columnMax = *std::max_element(m_qty.begin(), m_qty.end());
+    m_scale = std::max(m_scale, static_cast<double>(columnMax));
+
+    for (int row = 0; row < ROWS; row++) {
+        int64_t price = m_topTick - row;
+        if (price == m_bestBid) {
+            m_column[row] = BEST_BID;
+        } else if (price == m_bestAsk) {
+            m_column[row] = BEST_ASK;
+        } else if (m_qty[row] > 0 && m_scale > 0) {
+            // Square root, so thin levels still show next to a wall
+            float t = static_cast<float>(std::sqrt(std::min(1.0, m_qty[row] / m_scale)));
+            m_column[row] = price < m_bestBid ? mix(BID_LOW, BID_HIGH, t) : mix(ASK_LOW, ASK_HIGH, t);
+        } else {
+            m_column[row] = BACKGROUND;
+        }
+    }
+    writeColumn(m_head, m_column.data());
+}
+
+void LiquidityHeatmap::recenter(int64_t midTick) {
+    int64_t topTick = midTick + ROWS / 2;
+    int64_t shift = topTick - m_topTick;     // Rows every price moves down by
+    m_topTick = topTick;
+    if (shift == 0) return;
+
+    auto rowAt = [this](int64_t row) { return m_pixels.begin() + row * COLUMNS; };
+    if (shift >= ROWS || shift <= -ROWS) {
+        std::fill(m_pixels.begin(), m_pixels.end(), BACKGROUND);
+    } else if (shift > 0) {
+        std::copy_backward(rowAt(0), rowAt(ROWS - shift), rowAt(ROWS));
+        std::fill(rowAt(0), rowAt(shift), BACKGROUND);
+    } else {
+        std::copy(rowAt(-shift), rowAt(ROWS), rowAt(0));
+        std::fill(rowAt(ROWS + shift), rowAt(ROWS), BACKGROUND);
+    }
+    m_fullUpload = true;
+}
+
+void LiquidityHeatmap::handleZoom(Rectangle area) {
+    if (!CheckCollisionPointRec(GetMousePosition(), area)) return;
+    float wheel = GetMouseWheelMove();
+    if (wheel > 0) m_visibleColumns = std::max(m_visibleColumns / 2, 128);
+    if (wheel < 0) m_visibleColumns = std::min(m_visibleColumns * 2, COLUMNS);
+}
+
+void LiquidityHeatmap::draw(Rectangle area, const Font& font) {
+    DrawRectangleRec(area, BACKGROUND);
+    if (m_head < 0) {
+        DrawTextEx(font, "Waiting for the book", {area.x + 10, area.y + 10}, 16, 1, GRAY);
+        return;
+    }
+    ensureTexture();
+
+    // Newest column at the right edge; a short history fills the right part
+    int shown = std::min(m_filled, m_visibleColumns);
+    float columnWidth = area.width / m_visibleColumns;
+    int midRow = static_cast<int>(std::clamp<int64_t>(m_topTick - m_midTick, 0, ROWS - 1));
+    int top = std::clamp(midRow - m_visibleRows / 2, 0, ROWS - m_visibleRows);
+    float rowHeight = area.height / m_visibleRows;
+
+    // The ring wraps at most once: [oldest, end) then [0, head]
+    int oldest = (m_head - shown + 1 + COLUMNS) % COLUMNS;
+    int first = std::min(shown, COLUMNS - oldest);
+    float x = area.x + area.width - shown * columnWidth;
+    DrawTexturePro(m_texture, {(float)oldest, (float)top, (float)first, (float)m_visibleRows},
+                   {x, area.y, first * columnWidth, area.height}, {0, 0}, 0, WHITE);
+    if (shown > first) {
+        DrawTexturePro(m_texture, {0, (float)top, (float)(shown - first), (float)m_visibleRows},
+                       {x + first * columnWidth, area.y, (shown - first) * columnWidth, area.height}, {0, 0}, 0,
+                       WHITE);
+    }
+
+    // Price scale on the right, time span in the lower left
+    const int LABELS = 5;
+    char label[48];
+    for (int i = 0; i < LABELS; i++) {
+        int row = top + (m_visibleRows - 1) * i / (LABELS - 1);
+        formatFixed(label, sizeof(label), m_topTick - row, m_priceDecimals, m_priceDecimals);
+        Vector2 size = MeasureTextEx(font, label, 14, 1);
+        Vector2 position = {area.x + area.width - size.x - 6,
+                            std::clamp(area.y + (row - top) * rowHeight - 7, area.y, area.y + area.height - 14)};
+        DrawTextEx(font, label, {position.x + 1, position.y + 1}, 14, 1, {0, 0, 0, 160});
+        DrawTextEx(font, label, position, 14, 1, {220, 220, 220, 255});
+    }
+
+    double seconds = m_visibleColumns * COLUMN_SECONDS;
+    if (seconds >= 60) {
+        snprintf(label, sizeof(label), "%.1f min", seconds / 60);
+    } else {
+        snprintf(label, sizeof(label), "%.0f s", seconds);
+    }
+    DrawTextEx(font, label, {area.x + 6, area.y + area.height - 18}, 14, 1, GRAY);
+}
@@ -0,0 +1,100 @@
+//
+// Price x time liquidity history, bookmap-style, kept in one texture used as
+// a ring of columns.
+//
+// Every column is one time bucket: a pixel per price tick, colored by the
+// volume resting there (bids blue, asks red, the touch brighter). Columns are
+// fed from a LadderSnapshot (BookSnapshot.h), which holds every tick of the
+// book around the mid, so all ROWS rows show depth, not just the top levels. A book
+// update rewrites only the newest column and uploads it with
+// UpdateTextureRec, so scrolling costs one ROWS-pixel upload no matter how
+// much history is shown; drawing is two textured quads (the ring wraps once).
+// Rows are absolute prices. When the price drifts towards the edge of the
+// rows the history is shifted on the CPU copy and uploaded once in full.
+//
+// Only the render thread may call it; the texture is created on first use
+// and, like RowRenderCache, not released by the destructor (see unload()).
+//
+
+#ifndef LIQUIDITY_HEATMAP_H
+#define LIQUIDITY_HEATMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <raylib.h>
+
+class LiquidityHeatmap {
+public:
+    static constexpr int COLUMNS = 4096;            // 6.8 minutes of 100 ms columns
+    static constexpr int ROWS = 512;                // Price ticks kept around the mid
+    static constexpr double COLUMN_SECONDS = 0.1;
+
+    LiquidityHeatmap();
+
+    // Forgets the history, e.g. for another symbol or scale
+    void reset();
+
+    // Writes the ladder into the column of `now` (GetTime() seconds). Columns
+    // skipped since the last call repeat the book they last showed.
+    template <typename Ladder>
+    void add(double now, const Ladder& ladder);
+
+    // History oldest to newest from left to right, centred on the latest mid,
+    // with price labels on the right
+    void draw(Rectangle area, const Font& font);
+
+    // Mouse wheel over `area` zooms the time axis
+    void handleZoom(Rectangle area);
+
+    void unload();
+
+private:
+    // False when the book in the newest column is already this version
+    bool beginColumn(double now, uint64_t version, int priceDecimals, int qtyDecimals, int64_t bestBid,
+                     int64_t bestAsk);
+    void plot(int64_t price, int64_t qty);
+    void endColumn();
+    void writeColumn(int column, const Color* pixels);
+    void recenter(int64_t midTick);
+    void ensureTexture();
+
+    std::vector<Color> m_pixels;        // ROWS x COLUMNS, row-major: the CPU copy of the texture
+    std::vector<Color> m_column;        // Newest column, being built
+    std::vector<int64_t> m_qty;         // Volume per row of the newest column
+    std::vector<Color> m_upload;        // One column, packed for UpdateTextureRec
+    Texture2D m_texture = {};
+    bool m_textureLoaded = false;
+    bool m_fullUpload = false;          // The CPU copy moved as a whole since the last upload
+
+    int m_head = -1;                    // Column of the newest bucket, -1 before the first
+    int m_filled = 0;                   // Columns holding history
+    int64_t m_bucket = 0;               // Time bucket of m_head
+    int m_visibleColumns = 1024;
+    int m_visibleRows = 128;
+
+    int64_t m_topTick = 0;              // Price of row 0, in ticks of 10^-priceDecimals
+    int64_t m_midTick = 0;
+    int64_t m_bestBid = 0;
+    int64_t m_bestAsk = 0;
+    int m_priceDecimals = -1;
+    int m_qtyDecimals = -1;
+    uint64_t m_version = 0;             // Book version in the newest column
+    double m_scale = 0;                 // Volume drawn at full intensity, decays slowly
+};
+
+template <typename Ladder>
+void LiquidityHeatmap::add(double now, const Ladder& ladder) {
+    if (!ladder.filled || !ladder.scale.known()) return;
+    if (!beginColumn(now, ladder.version, ladder.scale.priceDecimals, ladder.scale.qtyDecimals, ladder.bestBid,
+                     ladder.bestAsk)) {
+        return;
+    }
+    // Rows outside the heatmap's own window are skipped by plot()
+    for (size_t row = 0; row < Ladder::ROWS; row++) {
+        if (ladder.qty[row]) plot(ladder.topTick - static_cast<int64_t>(row), ladder.qty[row]);
+    }
+    endColumn();
+}
+
+#endif //LIQUIDITY_HEATMAP_H
@@ -0,0 +1,62 @@
+#include "MEXC_Feed.h"
+
+#include <boost/asio/ssl/context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+
+template class VenueFeed<SpotVenue>;
+template class VenueFeed<FuturesVenue>;
+
+net::io_context g_ioc;
+ssl::context g_ctx{ssl::context::tlsv12_client};
+
+// The shard cores are split between the markets
+static const size_t SPOT_SHARDS = std::max<size_t>(ShardPool::defaultShardCount() / 2, 1);
+static const size_t FUTURES_SHARDS = std::max<size_t>(ShardPool::defaultShardCount() - SPOT_SHARDS, 1);
+
+SpotFeed g_spotFeed(g_ioc, g_ctx, SPOT_SHARDS);
+FuturesFeed g_futuresFeed(g_ioc, g_ctx, FUTURES_SHARDS);
+
+// Writes the stage tables to stdout every MEXC_LATENCY_DUMP seconds (default 10, 0 = off)
+static void scheduleLatencyDump() {
+    static net::steady_timer timer(g_ioc);
+    static const long interval = [] {
+        const char* seconds = std::getenv("MEXC_LATENCY_DUMP");
+        return seconds ? std::strtol(seconds, nullptr, 10) : 10L;
+    }();
+    if (interval <= 0) return;
+
+    timer.expires_after(std::chrono::seconds(interval));
+    timer.async_wait([](const boost::system::error_code& ec) {
+        if (ec) return;
+        if (g_spotFeed.symbolCount()) {
+            std::cout << "[" << SpotVenue::NAME << "]\n";
+            g_spotFeed.latency().dump(std::cout);
+        }
+        if (g_futuresFeed.symbolCount()) {
+            std::cout << "[" << FuturesVenue::NAME << "]\n";
+            g_futuresFeed.latency().dump(std::cout);
+        }
+        scheduleLatencyDump();
+    });
+}
+
+void MEXC_Feed_Start() {
+    g_ctx.set_verify_mode(ssl::verify_none);
+
+    // Cores 0 and 1 are left to the render and connection threads
+    g_spotFeed.start(2);
+    g_futuresFeed.start(2 + g_spotFeed.shardCount());
+    scheduleLatencyDump();
+}
+
+void MEXC_Feed_Stop() {
+    g_spotFeed.stop();
+    g_futuresFeed.stop();
+}
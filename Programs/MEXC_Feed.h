@@ -0,0 +1,35 @@
+//
+// Both MEXC markets in one process: the spot and futures feeds share the io
+// context and its connection thread, each with its own connections, shard
+// workers and books. Nothing here needs a window, so the raylib program and
+// MEXC_Daemon share it.
+//
+
+#ifndef MEXC_FEED_H
+#define MEXC_FEED_H
+
+#include <boost/asio/io_context.hpp>
+
+#include "MexcVenues.h"
+#include "VenueFeed.h"
+
+// Instantiated once, in MEXC_Feed.cpp
+extern template class VenueFeed<SpotVenue>;
+extern template class VenueFeed<FuturesVenue>;
+
+using SpotFeed = VenueFeed<SpotVenue>;
+using FuturesFeed = VenueFeed<FuturesVenue>;
+
+// Every websocket session runs on this io_context, driven by the connection thread
+extern boost::asio::io_context g_ioc;
+
+extern SpotFeed g_spotFeed;
+extern FuturesFeed g_futuresFeed;
+
+// Starts both feeds (see VenueFeed::start) and the latency dump. Run g_ioc
+// afterwards to serve them.
+void MEXC_Feed_Start();
+// Joins the shard workers once g_ioc has returned
+void MEXC_Feed_Stop();
+
+#endif //MEXC_FEED_H
@@ -0,0 +1,249 @@
+#include "MarketFeed.h"
+#include "LatencyHistogram.h"
+#include "MexcParser.h"
+
+#include <iostream>
+
+void FeedState::reset() {
+    scale = SymbolScale{};
+    trades = TradeBatch{};
+    depthLost = false;
+    book.clear();
+    sequencer.reset();
+}
+
+using ParseFn = bool (*)(std::string_view, MexcMessage&);
+
+// Moves the symbol to a scale with more decimals, rescaling its book so every
+// level keeps its exact value. The window then spans fewer prices; levels
+// that fell out of it are only sent again by full depth streams, so a diff
+// stream resyncs (see applyDelta).
+static void widenFeed(FeedState& feed, const SymbolScale& finer) {
+    if (feed.book.rescale(finer.priceDecimals - feed.scale.priceDecimals,
+                          finer.qtyDecimals - feed.scale.qtyDecimals)) {
+        feed.depthLost = true;
+    }
+    feed.scale = finer;
+}
+
+// Applies both sides of a depth message. Levels with more decimals than the
+// scale widen it first, then the whole message is applied again: levels are
+// absolute, so the ones already applied come out the same.
+static void applyDepth(FeedState& feed, const MexcMessage& msg) {
+    SymbolScale& scale = feed.scale;
+    if (!scale.known()) {
+        learnScale(scale, msg.asks);
+        learnScale(scale, msg.bids);
+    }
+    SymbolScale finer = scale;
+    applyLevels(feed.book, Side::Ask, msg.asks, scale, &finer);
+    applyLevels(feed.book, Side::Bid, msg.bids, scale, &finer);
+    if (finer == scale) return;
+
+    widenFeed(feed, finer);
+    applyLevels(feed.book, Side::Ask, msg.asks, scale);
+    applyLevels(feed.book, Side::Bid, msg.bids, scale);
+}
+
+// Rebuilds the book from a REST snapshot and replays the deltas buffered
+// since; false unless the book is live again. Attempts are spaced out so a
+// failing endpoint is not hammered. A
+// source that fetches in the background returns false until the snapshot is
+// there; the caller then resyncs again through resyncSpotBook/FuturesBook.
+static bool resyncBook(FeedState& feed, const SnapshotSource& snapshots, const char* venue,
+                       ParseFn parseSnapshot, ParseFn parseDelta) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - feed.lastResync < std::chrono::seconds(1)) return false;
+    feed.lastResync = now;
+
+    // Sources report their own failures
+    std::string body;
+    if (!snapshots(feed.symbol, body)) return false;
+
+    MexcMessage snapshot;
+    if (!parseSnapshot(body, snapshot)) {
+        std::cerr << venue << " depth snapshot for " << feed.symbol << " is unreadable" << std::endl;
+        return false;
+    }
+
+    feed.book.clear();
+    feed.depthLost = false;
+    applyDepth(feed, snapshot);
+
+    bool synced = feed.sequencer.onSnapshot(snapshot.version, [&feed, parseDelta](std::string_view raw) {
+        MexcMessage delta;
+        if (parseDelta(raw, delta)) applyDepth(feed, delta);
+    });
+    if (!synced) {
+        // What was rebuilt is not the market: leave nothing of it to publish
+        // until a snapshot lines up
+        std::cerr << venue << " depth snapshot " << snapshot.version << " is behind the stream, retrying" << std::endl;
+        feed.book.clear();
+        return false;
+    }
+    return true;
+}
+
+// Runs one diff message through the sequencer
+static FeedResult applyDelta(FeedState& feed, const MexcMessage& msg, std::string_view text,
+                             const SnapshotSource& snapshots, const char* venue,
+                             ParseFn parseSnapshot, ParseFn parseDelta) {
+    switch (feed.sequencer.onDelta(msg.fromVersion, msg.version, text)) {
+        case DepthSequencer::Result::Apply:
+            applyDepth(feed, msg);
+            if (feed.depthLost && snapshots) {
+                // Buffer from the next message on, which starts a resync
+                std::cerr << venue << " " << feed.symbol << " lost levels to a finer scale, resyncing" << std::endl;
+                feed.depthLost = false;
+                feed.sequencer.reset();
+            }
+            return FeedResult::Updated;
+        case DepthSequencer::Result::Gap:
+            std::cerr << venue << " depth gap after version " << feed.sequencer.lastVersion()
+                      << ", got " << msg.fromVersion << std::endl;
+            [[fallthrough]];
+        case DepthSequencer::Result::Buffered:
+            if (!snapshots) {
+                // No snapshot to wait for: continue from this message, which
+                // the sequencer has just buffered
+                feed.sequencer.onSnapshot(msg.fromVersion - 1, [&feed, parseDelta](std::string_view raw) {
+                    MexcMessage delta;
+                    if (parseDelta(raw, delta)) applyDepth(feed, delta);
+                });
+                return FeedResult::Updated;
+            }
+            return resyncBook(feed, snapshots, venue, parseSnapshot, parseDelta) ? FeedResult::Updated
+                                                                                 : FeedResult::Unchanged;
+        case DepthSequencer::Result::Stale:
+            break;
+    }
+    return FeedResult::Unchanged;
+}
+
+// Sums the trades of a deals frame into feed.trades. A trade with more
+// decimals than the scale widens it, and the frame is summed again.
+static FeedResult applyDeals(FeedState& feed, std::string_view deals) {
+    const SymbolScale& scale = feed.scale;
+    TradeBatch& batch = feed.trades;
+    batch = TradeBatch{};
+    if (!scale.known()) return FeedResult::Unchanged;
+
+    SymbolScale finer = scale;
+    auto sum = [&](std::string_view priceText, std::string_view qtyText, bool takerBuy) {
+        int64_t price, qty;
+        bool exact = true;
+        if (!parseFixed(priceText, scale.priceDecimals, price, &exact) ||
+            !parseFixed(qtyText, scale.qtyDecimals, qty, &exact)) {
+            return;
+        }
+        if (!exact) {
+            widenScale(finer, priceText, qtyText);
+            return;
+        }
+        if (qty <= 0) return;
+        (takerBuy ? batch.buyQty : batch.sellQty) += qty;
+        batch.notional += fixedToDouble(price, scale.priceDecimals) * fixedToDouble(qty, scale.qtyDecimals);
+        batch.count++;
+    };
+    forEachDeal(deals, sum);
+    if (!(finer == scale)) {
+        widenFeed(feed, finer);
+        batch = TradeBatch{};
+        forEachDeal(deals, sum);
+    }
+    return batch.count ? FeedResult::Traded : FeedResult::Unchanged;
+}
+
+FeedResult applySpotFrame(FeedState& feed, std::string_view text, const SnapshotSource& snapshots,
+                          size_t limitedDepth, FeedTiming* timing) {
+    SymbolScale& scale = feed.scale;
+
+    // Parse in place; the views in msg only live as long as text
+    MexcMessage msg;
+    if (!parseSpotMessage(text, msg)) return FeedResult::NotMarketData;
+    if (timing) *timing = {steadyNowNs(), msg.timestamp};
+
+    switch (msg.type) {
+        case MexcMessageType::SpotDepth:
+            // The first message of a subscription sets the symbol's decimals
+            applyDepth(feed, msg);
+
+            // Maintain the stream's maximum number of levels
+            feed.book.truncate(limitedDepth);
+            return FeedResult::Updated;
+
+        case MexcMessageType::SpotDepthDelta:
+            // Apply only changed levels while versions are continuous
+            return applyDelta(feed, msg, text, snapshots, "Spot", parseSpotSnapshot, parseSpotMessage);
+
+        case MexcMessageType::SpotBookTicker: {
+            SymbolScale finer = scale;
+            widenScale(finer, msg.askPrice, msg.askQty);
+            widenScale(finer, msg.bidPrice, msg.bidQty);
+            if (!scale.known()) {
+                scale = finer;
+            } else if (!(finer == scale)) {
+                widenFeed(feed, finer);
+            }
+
+            int64_t askPrice, askVolume, bidPrice, bidVolume;
+            if (!parseFixed(msg.askPrice, scale.priceDecimals, askPrice) ||
+                !parseFixed(msg.askQty, scale.qtyDecimals, askVolume) ||
+                !parseFixed(msg.bidPrice, scale.priceDecimals, bidPrice) ||
+                !parseFixed(msg.bidQty, scale.qtyDecimals, bidVolume)) {
+                return FeedResult::Unchanged;
+            }
+            // Update best ask and bid; stale levels in front of them are removed
+            feed.book.setBest(Side::Ask, askPrice, askVolume);
+            feed.book.setBest(Side::Bid, bidPrice, bidVolume);
+            feed.book.truncate(limitedDepth);
+            return FeedResult::Updated;
+        }
+
+        case MexcMessageType::SpotDeals:
+            return applyDeals(feed, msg.deals);
+
+        default:
+            return FeedResult::NotMarketData;
+    }
+}
+
+FeedResult resyncSpotBook(FeedState& feed, const SnapshotSource& snapshots) {
+    feed.lastResync = {};
+    return resyncBook(feed, snapshots, "Spot", parseSpotSnapshot, parseSpotMessage) ? FeedResult::Updated
+                                                                                     : FeedResult::Unchanged;
+}
+
+FeedResult applyFuturesFrame(FeedState& feed, std::string_view text, const SnapshotSource& snapshots,
+                             FeedTiming* timing) {
+    MexcMessage msg;
+    if (!parseFuturesMessage(text, msg)) return FeedResult::NotMarketData;
+    if (timing) *timing = {steadyNowNs(), msg.timestamp};
+
+    switch (msg.type) {
+        case MexcMessageType::FuturesPong:
+            return FeedResult::Unchanged;
+
+        case MexcMessageType::FuturesDepthFull:
+            // Clear existing orders when receiving full snapshot
+            feed.book.clear();
+            applyDepth(feed, msg);
+            return FeedResult::Updated;
+
+        case MexcMessageType::FuturesDepth:
+            // Apply only the changed levels while the version sequence is unbroken
+            return applyDelta(feed, msg, text, snapshots, "Futures", parseFuturesSnapshot, parseFuturesMessage);
+
+        case MexcMessageType::FuturesDeal:
+            return applyDeals(feed, msg.deals);
+
+        default:
+            return FeedResult::NotMarketData;
+    }
+}
+
+FeedResult resyncFuturesBook(FeedState& feed, const SnapshotSource& snapshots) {
+    feed.lastResync = {};
+    return resyncBook(feed, snapshots, "Futures", parseFuturesSnapshot, parseFuturesMessage) ? FeedResult::Updated
+                                                                                             : FeedResult::Unchanged;
+}
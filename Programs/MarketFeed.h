@@ -0,0 +1,82 @@
+//
+// Applies MEXC market data frames to a symbol's book.
+//
+// This is the parse -> sequence -> apply path shared by the live feed (on
+// the shard workers) and by the replay tool, so both run exactly the same
+// code on the same input. Publishing the result is left to the caller.
+//
+
+#ifndef MARKET_FEED_H
+#define MARKET_FEED_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "FixedPoint.h"
+#include "OrderBookEngine.h"
+#include "DepthSequencer.h"
+#include "SnapshotSource.h"
+
+// Trades of the latest deals frame, summed as they were parsed so the caller
+// folds a whole burst into its statistics at once
+struct TradeBatch {
+    uint32_t count = 0;
+    int64_t buyQty = 0;         // Taker buys, in qty ticks
+    int64_t sellQty = 0;        // Taker sells
+    double notional = 0;        // Sum of price * qty, for the VWAP
+};
+
+// Book and sequencing state of one symbol
+struct FeedState {
+    std::string symbol;
+    OrderBookEngine book;
+    DepthSequencer sequencer;
+    SymbolScale scale;          // Learned from the first message, widened by finer ones
+    std::chrono::steady_clock::time_point lastResync;
+    TradeBatch trades;          // Of the latest deals frame
+    bool depthLost = false;     // A rescale dropped levels that a diff stream will not send again
+
+    // Forgets everything learned from the stream; the symbol stays
+    void reset();
+};
+
+// Filled in by the apply functions for the caller's latency stages
+struct FeedTiming {
+    int64_t parsedNs = 0;       // steadyNowNs() once the frame was parsed
+    int64_t exchangeMs = 0;     // Exchange time of the frame ("t" / "ts"), 0 if absent
+};
+
+enum class FeedResult {
+    Updated,        // The book changed: publish it
+    Unchanged,      // Market data that left the book as it was (stale, buffered)
+    Traded,         // A deals frame, summed into FeedState::trades; the book is as it was
+    NotMarketData   // Replies, errors, pongs: not handled here
+};
+
+// Diff streams that lose sequence are rebuilt from `snapshots`. With an empty
+// source (replay) the stream is taken as is: the book continues from the
+// message that started or broke the sequence. A source may return false while
+// it fetches the snapshot in the background (VenueFeed), and have the book
+// rebuilt with resyncSpotBook / resyncFuturesBook once it has it.
+//
+// limitedDepth is the level count of the limited spot depth and bookTicker
+// streams; their books are cut to it after every message.
+//
+// Values are never rounded to the symbol's scale: a level or trade with more
+// decimals widens the scale and the book is rescaled to it first. Trades are
+// only taken once the depth stream has set the scale.
+FeedResult applySpotFrame(FeedState& feed, std::string_view text, const SnapshotSource& snapshots,
+                          size_t limitedDepth, FeedTiming* timing = nullptr);
+FeedResult applyFuturesFrame(FeedState& feed, std::string_view text, const SnapshotSource& snapshots,
+                             FeedTiming* timing = nullptr);
+
+// Rebuilds the book from `snapshots` now, whatever the time of the last
+// attempt. Updated once the book is live again. A snapshot behind the stream
+// leaves the book empty and Unchanged; the next message fetches another.
+FeedResult resyncSpotBook(FeedState& feed, const SnapshotSource& snapshots);
+FeedResult resyncFuturesBook(FeedState& feed, const SnapshotSource& snapshots);
+
+#endif //MARKET_FEED_H
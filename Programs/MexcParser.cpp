@@ -0,0 +1,272 @@
+#include "MexcParser.h"
+
+bool JsonCursor::skipValue(std::string_view* span) {
+    skipWhitespace();
+    if (m_p >= m_end) return fail();
+    const char* start = m_p;
+
+    char c = *m_p;
+    if (c == '"') {
+        m_p++;
+        if (!skipStringBody()) return false;
+    } else if (c == '{' || c == '[') {
+        // Walk the structural characters 64 bytes at a time, tracking
+        // strings so brackets inside them are ignored
+        int depth = 0;
+        bool inString = false;
+        const char* escaped = m_p;  // Characters before this are consumed
+        auto closes = [&](const char* q) {
+            if (q < escaped) return false;
+            char ch = *q;
+            if (inString) {
+                if (ch == '"') inString = false;
+                else if (ch == '\\') escaped = q + 2;
+                return false;
+            }
+            if (ch == '"') inString = true;
+            else if (ch == '{' || ch == '[') depth++;
+            else if (ch == '}' || ch == ']') return --depth == 0;
+            return false;
+        };
+        bool closed = false;
+        while (!closed) {
+            if (m_end - m_p >= 64) {
+                const char* block = m_p;
+                m_p += 64;
+                for (uint64_t mask = structuralMask64(block); mask; mask &= mask - 1) {
+                    const char* q = block + __builtin_ctzll(mask);
+                    if (closes(q)) {
+                        m_p = q + 1;
+                        closed = true;
+                        break;
+                    }
+                }
+            } else {
+                if (m_p >= m_end) return fail();
+                closed = closes(m_p++);
+            }
+        }
+    } else {
+        skipLiteral();
+        if (m_p == start) return fail();
+    }
+
+    if (span) *span = std::string_view(start, static_cast<size_t>(m_p - start));
+    return true;
+}
+
+static bool readInteger(JsonCursor& c, int64_t& out) {
+    std::string_view text;
+    if (!c.readScalar(text)) return false;
+    if (!parseFixed(text, 0, out)) out = 0;
+    return true;
+}
+
+// Reads the members of a spot "d" object; the cursor is just past its
+// opening brace. The level arrays are skipped once and kept as spans.
+static void readSpotData(JsonCursor& c, MexcMessage& msg, bool& hasAsks, bool& hasBids) {
+    std::string_view key;
+    while (c.nextMember(key)) {
+        if (key == "asks") hasAsks = c.skipValue(&msg.asks);
+        else if (key == "bids") hasBids = c.skipValue(&msg.bids);
+        else if (key == "a") c.readScalar(msg.askPrice);
+        else if (key == "A") c.readScalar(msg.askQty);
+        else if (key == "b") c.readScalar(msg.bidPrice);
+        else if (key == "B") c.readScalar(msg.bidQty);
+        else if (key == "r" || key == "toVersion") readInteger(c, msg.version);
+        else if (key == "fromVersion") readInteger(c, msg.fromVersion);
+        else if (key == "deals") c.skipValue(&msg.deals);
+        else c.skipValue();
+    }
+}
+
+bool parseSpotMessage(std::string_view text, MexcMessage& msg) {
+    msg = MexcMessage{};
+
+    JsonCursor c(text);
+    if (!c.beginObject()) return false;
+
+    // "d" is read in place, in the same pass as the envelope
+    std::string_view key;
+    bool hasAsks = false;
+    bool hasBids = false;
+    while (c.nextMember(key)) {
+        if (key == "c") c.readString(msg.channel);
+        else if (key == "s") c.readString(msg.symbol);
+        else if (key == "t") readInteger(c, msg.timestamp);
+        else if (key == "d" && c.peek('{')) {
+            c.beginObject();
+            readSpotData(c, msg, hasAsks, hasBids);
+        } else c.skipValue();
+    }
+    if (c.failed()) return false;
+    if (msg.fromVersion == 0) msg.fromVersion = msg.version;
+
+    // Diff-depth streams may omit an empty side, limited depth always carries both
+    bool diffDepth = msg.channel.find("increase.depth") != std::string_view::npos ||
+                     msg.channel.find("aggre.depth") != std::string_view::npos;
+    if (!msg.deals.empty()) {
+        msg.type = MexcMessageType::SpotDeals;
+    } else if (diffDepth && (hasAsks || hasBids)) {
+        msg.type = MexcMessageType::SpotDepthDelta;
+    } else if (hasAsks && hasBids) {
+        msg.type = MexcMessageType::SpotDepth;
+    } else if (!msg.askPrice.empty() && !msg.bidPrice.empty()) {
+        msg.type = MexcMessageType::SpotBookTicker;
+    }
+    return true;
+}
+
+// Reads asks/bids/version out of a futures "data" object, the cursor just
+// before its opening brace
+static bool readFuturesDepthData(JsonCursor& c, MexcMessage& msg) {
+    if (!c.beginObject()) return false;
+    std::string_view key;
+    while (c.nextMember(key)) {
+        if (key == "asks") c.skipValue(&msg.asks);
+        else if (key == "bids") c.skipValue(&msg.bids);
+        else if (key == "version") readInteger(c, msg.version);
+        else c.skipValue();
+    }
+    return !c.failed();
+}
+
+static bool isFuturesDepthChannel(std::string_view channel) {
+    return channel == "push.depth.full" || channel == "push.depth";
+}
+
+bool parseFuturesMessage(std::string_view text, MexcMessage& msg) {
+    msg = MexcMessage{};
+
+    JsonCursor c(text);
+    if (!c.beginObject()) return false;
+
+    // MEXC sends "channel" before "data", so depth data is read in place.
+    // Otherwise it is kept as a span and read once the channel is known.
+    std::string_view key;
+    std::string_view payload;
+    bool depthRead = false;
+    while (c.nextMember(key)) {
+        if (key == "channel") c.readString(msg.channel);
+        else if (key == "symbol") c.readString(msg.symbol);
+        else if (key == "ts") readInteger(c, msg.timestamp);
+        else if (key == "data") {
+            if (isFuturesDepthChannel(msg.channel) && c.peek('{')) depthRead = readFuturesDepthData(c, msg);
+            else c.skipValue(&payload);
+        } else c.skipValue();
+    }
+    if (c.failed()) return false;
+
+    if (msg.channel == "pong") {
+        msg.type = MexcMessageType::FuturesPong;
+    } else if (isFuturesDepthChannel(msg.channel)) {
+        if (!depthRead) {
+            if (payload.empty() || payload.front() != '{') return true;
+            JsonCursor d(payload);
+            if (!readFuturesDepthData(d, msg)) return false;
+        }
+        msg.fromVersion = msg.version;
+        msg.type = msg.channel == "push.depth" ? MexcMessageType::FuturesDepth
+                                               : MexcMessageType::FuturesDepthFull;
+    } else if (msg.channel == "push.deal") {
+        if (payload.empty() || (payload.front() != '{' && payload.front() != '[')) return true;
+        msg.deals = payload;
+        msg.type = MexcMessageType::FuturesDeal;
+    }
+    return true;
+}
+
+bool peekString(std::string_view text, std::string_view key, std::string_view& value) {
+    JsonCursor c(text);
+    if (!c.beginObject()) return false;
+
+    std::string_view member;
+    while (c.nextMember(member)) {
+        if (member == key) return c.readString(value);
+        c.skipValue();
+    }
+    return false;
+}
+
+bool peekInteger(std::string_view text, std::string_view key, int64_t& value) {
+    JsonCursor c(text);
+    if (!c.beginObject()) return false;
+
+    std::string_view member;
+    while (c.nextMember(member)) {
+        if (member == key) return readInteger(c, value);
+        c.skipValue();
+    }
+    return false;
+}
+
+bool parseSpotSnapshot(std::string_view text, MexcMessage& msg) {
+    msg = MexcMessage{};
+
+    JsonCursor c(text);
+    if (!c.beginObject()) return false;
+
+    std::string_view key;
+    bool hasAsks = false;
+    bool hasBids = false;
+    while (c.nextMember(key)) {
+        if (key == "asks") hasAsks = c.skipValue(&msg.asks);
+        else if (key == "bids") hasBids = c.skipValue(&msg.bids);
+        else if (key == "lastUpdateId") readInteger(c, msg.version);
+        else c.skipValue();
+    }
+    if (c.failed() || !hasAsks || !hasBids) return false;
+
+    msg.fromVersion = msg.version;
+    msg.type = MexcMessageType::SpotDepth;
+    return true;
+}
+
+bool parseFuturesSnapshot(std::string_view text, MexcMessage& msg) {
+    msg = MexcMessage{};
+
+    JsonCursor c(text);
+    if (!c.beginObject()) return false;
+
+    std::string_view key;
+    std::string_view success;
+    bool hasData = false;
+    while (c.nextMember(key)) {
+        if (key == "data" && c.peek('{')) hasData = readFuturesDepthData(c, msg);
+        else if (key == "success") c.readScalar(success);
+        else c.skipValue();
+    }
+    if (c.failed() || !hasData || success == "false") return false;
+
+    msg.fromVersion = msg.version;
+    msg.type = MexcMessageType::FuturesDepthFull;
+    return true;
+}
+
+void learnScale(SymbolScale& scale, std::string_view levels) {
+    forEachLevel(levels, [&scale](std::string_view price, std::string_view qty, std::string_view) {
+        widenScale(scale, price, qty);
+    });
+}
+
+size_t applyLevels(OrderBookEngine& book, Side side, std::string_view levels, const SymbolScale& scale,
+                   SymbolScale* finer) {
+    size_t applied = 0;
+    forEachLevel(levels, [&](std::string_view priceText, std::string_view qtyText, std::string_view ordersText) {
+        int64_t price, qty, orders = 0;
+        bool exact = true;
+        if (!parseFixed(priceText, scale.priceDecimals, price, &exact) ||
+            !parseFixed(qtyText, scale.qtyDecimals, qty, &exact)) {
+            return;
+        }
+        // A rounded price would land on another level, a rounded qty could delete one
+        if (!exact) {
+            if (finer) widenScale(*finer, priceText, qtyText);
+            return;
+        }
+        if (!ordersText.empty()) parseFixed(ordersText, 0, orders);
+        book.update(side, price, qty, static_cast<int32_t>(orders));
+        applied++;
+    });
+    return applied;
+}
@@ -0,0 +1,344 @@
+//
+// Allocation-free, on-demand parser for the MEXC depth, bookTicker and deals
+// messages.
+//
+// The message is walked in place (straight out of the websocket's
+// flat_buffer); nothing is copied and no DOM is built. Values come back as
+// string_views into the original text, and depth and trade arrays are only
+// walked when a caller asks for their entries. Skipping over values uses SIMD
+// to find the structural characters of 64 bytes at a time. Anything that is not a recognised market
+// data message is reported as Unknown so the caller can fall back to
+// nlohmann::json.
+//
+
+#ifndef MEXC_PARSER_H
+#define MEXC_PARSER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "FixedPoint.h"
+#include "OrderBookEngine.h"
+
+// Returns the first '"' or '\\' in [p, end), or end
+inline const char* scanQuoteOrEscape(const char* p, const char* end) {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i escape = _mm256_set1_epi8('\\');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, escape))));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote16 = _mm_set1_epi8('"');
+    const __m128i escape16 = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote16), _mm_cmpeq_epi8(chunk, escape16))));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\') p++;
+    return p;
+}
+
+// Bit i is set when p[i] is one of '"', '\\', '{', '}', '[', ']'. Reads 64
+// bytes from p.
+inline uint64_t structuralMask64(const char* p) {
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i escape = _mm256_set1_epi8('\\');
+    const __m256i openBrace = _mm256_set1_epi8('{');
+    const __m256i closeBrace = _mm256_set1_epi8('}');
+    const __m256i openBracket = _mm256_set1_epi8('[');
+    const __m256i closeBracket = _mm256_set1_epi8(']');
+    auto half = [&](const char* q) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q));
+        __m256i hits = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, escape)),
+            _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, openBrace), _mm256_cmpeq_epi8(chunk, closeBrace)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, openBracket), _mm256_cmpeq_epi8(chunk, closeBracket))));
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hits)));
+    };
+    return half(p) | (half(p + 32) << 32);
+#elif defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    const __m128i openBrace = _mm_set1_epi8('{');
+    const __m128i closeBrace = _mm_set1_epi8('}');
+    const __m128i openBracket = _mm_set1_epi8('[');
+    const __m128i closeBracket = _mm_set1_epi8(']');
+    auto quarter = [&](const char* q) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, escape)),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, openBrace), _mm_cmpeq_epi8(chunk, closeBrace)),
+                         _mm_or_si128(_mm_cmpeq_epi8(chunk, openBracket), _mm_cmpeq_epi8(chunk, closeBracket))));
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hits)));
+    };
+    return quarter(p) | (quarter(p + 16) << 16) | (quarter(p + 32) << 32) | (quarter(p + 48) << 48);
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        char c = p[i];
+        if (c == '"' || c == '\\' || c == '{' || c == '}' || c == '[' || c == ']') mask |= uint64_t(1) << i;
+    }
+    return mask;
+#endif
+}
+
+// Forward-only cursor over JSON text. Every read either advances past a
+// complete token or marks the cursor as failed.
+class JsonCursor {
+public:
+    explicit JsonCursor(std::string_view text)
+        : m_p(text.data()), m_end(text.data() + text.size()) {}
+
+    bool failed() const { return m_failed; }
+
+    bool peek(char c) {
+        skipWhitespace();
+        return m_p < m_end && *m_p == c;
+    }
+
+    bool beginObject() { return expect('{'); }
+    bool beginArray() { return expect('['); }
+
+    // Advances to the next member of the current object and reads its key.
+    // Returns false at the closing brace or on error.
+    bool nextMember(std::string_view& key) {
+        skipWhitespace();
+        if (m_p < m_end && *m_p == '}') {
+            m_p++;
+            return false;
+        }
+        if (m_p < m_end && *m_p == ',') {
+            m_p++;
+            skipWhitespace();
+        }
+        if (!readString(key)) return false;
+        return expect(':');
+    }
+
+    // Advances to the next element of the current array. Returns false at the
+    // closing bracket or on error.
+    bool nextElement() {
+        skipWhitespace();
+        if (m_p >= m_end) return fail();
+        if (*m_p == ']') {
+            m_p++;
+            return false;
+        }
+        if (*m_p == ',') m_p++;
+        return true;
+    }
+
+    // Reads a string value; escapes are left as they appear on the wire
+    bool readString(std::string_view& out) {
+        skipWhitespace();
+        if (m_p >= m_end || *m_p != '"') return fail();
+        const char* start = ++m_p;
+        if (!skipStringBody()) return false;
+        out = std::string_view(start, static_cast<size_t>(m_p - 1 - start));
+        return true;
+    }
+
+    // Reads a string's contents or the raw text of a number/literal
+    bool readScalar(std::string_view& out) {
+        skipWhitespace();
+        if (m_p >= m_end) return fail();
+        if (*m_p == '"') return readString(out);
+        if (*m_p == '{' || *m_p == '[') return fail();
+        const char* start = m_p;
+        skipLiteral();
+        if (m_p == start) return fail();
+        out = std::string_view(start, static_cast<size_t>(m_p - start));
+        return true;
+    }
+
+    // Skips any value; if span is given it receives the value's raw text
+    bool skipValue(std::string_view* span = nullptr);
+
+private:
+    void skipWhitespace() {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) m_p++;
+    }
+
+    void skipLiteral() {
+        while (m_p < m_end) {
+            char c = *m_p;
+            if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t') break;
+            m_p++;
+        }
+    }
+
+    // m_p is just past the opening quote; leaves it just past the closing one
+    bool skipStringBody() {
+        for (;;) {
+            m_p = scanQuoteOrEscape(m_p, m_end);
+            if (m_p >= m_end) return fail();
+            if (*m_p == '"') {
+                m_p++;
+                return true;
+            }
+            m_p += 2;  // Escape and the escaped character
+        }
+    }
+
+    bool expect(char c) {
+        skipWhitespace();
+        if (m_p >= m_end || *m_p != c) return fail();
+        m_p++;
+        return true;
+    }
+
+    bool fail() {
+        m_failed = true;
+        m_p = m_end;
+        return false;
+    }
+
+    const char* m_p;
+    const char* m_end;
+    bool m_failed = false;
+};
+
+enum class MexcMessageType {
+    Unknown,
+    SpotDepth,
+    SpotDepthDelta,
+    SpotBookTicker,
+    FuturesDepthFull,
+    FuturesDepth,
+    FuturesPong,
+    SpotDeals,
+    FuturesDeal
+};
+
+// Fields of interest from one message. All views point into the message text.
+struct MexcMessage {
+    MexcMessageType type = MexcMessageType::Unknown;
+    std::string_view channel;   // "c" (spot) or "channel" (futures)
+    std::string_view symbol;    // "s" or "symbol"
+    int64_t timestamp = 0;      // Exchange time in ms: "t" or "ts"
+    int64_t version = 0;        // Spot "r"/"toVersion", futures "version"; 0 if absent
+    int64_t fromVersion = 0;    // First version covered; equals version unless the message is aggregated
+
+    // Depth messages: raw text of the level arrays
+    std::string_view asks;
+    std::string_view bids;
+
+    // bookTicker messages
+    std::string_view askPrice;
+    std::string_view askQty;
+    std::string_view bidPrice;
+    std::string_view bidQty;
+
+    // Deals messages: raw text of the trades, an array (spot, batched
+    // futures) or a single object (futures)
+    std::string_view deals;
+};
+
+// Scans a message without walking the level arrays. Returns false if the
+// text is not well-formed JSON as far as it was read; a well-formed message
+// that is not market data comes back with type Unknown.
+bool parseSpotMessage(std::string_view text, MexcMessage& msg);
+bool parseFuturesMessage(std::string_view text, MexcMessage& msg);
+
+// Reads one top-level string member (e.g. "s" or "symbol") and skips the
+// rest without looking inside it. Used to route raw frames by symbol.
+bool peekString(std::string_view text, std::string_view key, std::string_view& value);
+bool peekInteger(std::string_view text, std::string_view key, int64_t& value);
+
+// Parse REST depth snapshots: GET /api/v3/depth (spot, version is
+// lastUpdateId) and GET /api/v1/contract/depth/{symbol} (futures)
+bool parseSpotSnapshot(std::string_view text, MexcMessage& msg);
+bool parseFuturesSnapshot(std::string_view text, MexcMessage& msg);
+
+// Walks a level array, calling fn(price, qty, orders) with the raw text of
+// each level. Spot levels are {"p":..,"v":..} objects (orders is empty),
+// futures levels are [price, qty, orders] arrays.
+template <typename Fn>
+bool forEachLevel(std::string_view levels, Fn&& fn) {
+    if (levels.empty()) return true;
+
+    JsonCursor c(levels);
+    if (!c.beginArray()) return false;
+    while (c.nextElement()) {
+        std::string_view price, qty, orders;
+        if (c.peek('{')) {
+            c.beginObject();
+            std::string_view key;
+            while (c.nextMember(key)) {
+                if (key == "p") c.readScalar(price);
+                else if (key == "v") c.readScalar(qty);
+                else c.skipValue();
+            }
+        } else if (c.peek('[')) {
+            c.beginArray();
+            for (int field = 0; c.nextElement(); field++) {
+                std::string_view value;
+                if (!c.readScalar(value)) break;
+                if (field == 0) price = value;
+                else if (field == 1) qty = value;
+                else if (field == 2) orders = value;
+            }
+        } else {
+            return false;
+        }
+        if (c.failed()) return false;
+        fn(price, qty, orders);
+    }
+    return !c.failed();
+}
+
+// Walks the trades of a deals message, calling fn(price, qty, takerBuy) with
+// the raw text of each. Spot trades carry the taker side in "S", futures
+// trades in "T" (1 buy, 2 sell).
+template <typename Fn>
+bool forEachDeal(std::string_view deals, Fn&& fn) {
+    if (deals.empty()) return true;
+
+    JsonCursor c(deals);
+    bool array = c.peek('[');
+    if (array) c.beginArray();
+    while (!array || c.nextElement()) {
+        if (!c.beginObject()) return false;
+        std::string_view key, price, qty, side;
+        while (c.nextMember(key)) {
+            if (key == "p") c.readScalar(price);
+            else if (key == "v") c.readScalar(qty);
+            else if (key == "S" || key == "T") c.readScalar(side);
+            else c.skipValue();
+        }
+        if (c.failed()) return false;
+        fn(price, qty, side == "1");
+        if (!array) break;
+    }
+    return !c.failed();
+}
+
+// Widens the scale to cover every level of a depth array
+void learnScale(SymbolScale& scale, std::string_view levels);
+
+// Applies every level of a depth array to one side of the book. A zero
+// quantity removes the level. A level with more decimals than `scale` is
+// never rounded into the book: it is skipped, and `finer`, when given, is
+// widened to cover it so the caller can rescale and apply the array again.
+// Returns the number of levels applied.
+size_t applyLevels(OrderBookEngine& book, Side side, std::string_view levels, const SymbolScale& scale,
+                   SymbolScale* finer = nullptr);
+
+#endif //MEXC_PARSER_H
@@ -0,0 +1,120 @@
+#include "MexcVenues.h"
+#include "WebSocketSession.h"
+
+#include <chrono>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+std::string SpotVenue::symbol(std::string_view base, std::string_view quote) {
+    return std::string(base) + std::string(quote);
+}
+
+SubscriptionManager::Venue SpotVenue::connection(bool incrementalDepth) {
+    return {
+        // MEXC_SPOT_ENDPOINT=wss://host:port/ws redirects to e.g. MEXC_MockServer
+        .options = endpointFromEnv("MEXC_SPOT_ENDPOINT", {
+            .host = "wbs.mexc.com",
+            .target = "/ws",
+            .pingMessage = R"({"method":"PING"})",
+        }),
+        // MEXC allows 30 streams per connection
+        .symbolsPerConnection = incrementalDepth ? 15u : 10u,
+        .symbolKey = "s",
+        .timestampKey = "t",
+        .subscribe = [incrementalDepth](const std::string& symbol) -> std::vector<std::string> {
+            // The diff stream carries the best levels itself; bookTicker would race it
+            json params = incrementalDepth
+                ? json::array({
+                    "spot@public.increase.depth.v3.api@" + symbol,
+                    "spot@public.deals.v3.api@" + symbol
+                })
+                : json::array({
+                    "spot@public.limit.depth.v3.api@" + symbol + "@20",
+                    "spot@public.bookTicker.v3.api@" + symbol,
+                    "spot@public.deals.v3.api@" + symbol
+                });
+            json subscriptionMsg = {
+                {"method", "SUBSCRIPTION"},
+                {"params", params}
+            };
+            return {subscriptionMsg.dump()};
+        },
+        .other = other,
+    };
+}
+
+void SpotVenue::other(std::string_view text) {
+    // Runs in the connection's read loop: a frame that is not JSON must not throw out of it
+    json j = json::parse(text, nullptr, false);
+    if (j.is_discarded()) return;
+    if (j.contains("code") && j["code"] != 0) {
+        std::cerr << "MEXC spot error: " << j.dump() << std::endl;
+    }
+}
+
+AsyncSnapshotSource SpotVenue::snapshots(boost::asio::io_context& ioc) {
+    return asyncSnapshotSourceFromEnv(ioc, "MEXC_SPOT_SNAPSHOT",
+        "https://api.mexc.com/api/v3/depth?symbol={symbol}&limit=5000");
+}
+
+std::string FuturesVenue::symbol(std::string_view base, std::string_view quote) {
+    return std::string(base) + "_" + std::string(quote);
+}
+
+SubscriptionManager::Venue FuturesVenue::connection(bool incrementalDepth) {
+    return {
+        // MEXC_FUTURES_ENDPOINT=wss://host:port/edge redirects to e.g. MEXC_MockServer
+        .options = endpointFromEnv("MEXC_FUTURES_ENDPOINT", {
+            .host = "contract.mexc.com",
+            .target = "/edge",
+            .pingMessage = R"({"method":"ping"})",
+            .pingInterval = std::chrono::seconds(15),
+            .idleTimeout = std::chrono::seconds(30),
+        }),
+        .symbolsPerConnection = 30,
+        .symbolKey = "symbol",
+        .timestampKey = "ts",
+        .subscribe = [incrementalDepth](const std::string& symbol) -> std::vector<std::string> {
+            // Subscribe to incremental depth, or to full depth with 20 levels,
+            // and to the symbol's trades
+            json subscriptionMsg = incrementalDepth
+                ? json{
+                    {"method", "sub.depth"},
+                    {"param", {
+                        {"symbol", symbol}
+                    }}
+                }
+                : json{
+                    {"method", "sub.depth.full"},
+                    {"param", {
+                        {"symbol", symbol},
+                        {"limit", 20}
+                    }}
+                };
+            json dealMsg = {
+                {"method", "sub.deal"},
+                {"param", {
+                    {"symbol", symbol}
+                }}
+            };
+            return {subscriptionMsg.dump(), dealMsg.dump()};
+        },
+        .other = other,
+    };
+}
+
+void FuturesVenue::other(std::string_view text) {
+    // Runs in the connection's read loop: a frame that is not JSON must not throw out of it
+    json j = json::parse(text, nullptr, false);
+    if (j.is_discarded()) return;
+    if (j.contains("channel") && j["channel"] == "rs.error") {
+        std::cerr << "MEXC futures error: " << j.dump() << std::endl;
+    }
+}
+
+AsyncSnapshotSource FuturesVenue::snapshots(boost::asio::io_context& ioc) {
+    return asyncSnapshotSourceFromEnv(ioc, "MEXC_FUTURES_SNAPSHOT",
+        "https://contract.mexc.com/api/v1/contract/depth/{symbol}");
+}
@@ -0,0 +1,98 @@
+//
+// Compile-time descriptions of the MEXC markets for VenueFeed.
+//
+// A venue policy is a plain struct of types, constants and static functions:
+// the level entry published to readers, where and how to subscribe, and the
+// frame schema (through its apply function). VenueFeed<Policy> calls them
+// directly, so the per-frame path is resolved at compile time. Only the
+// connection settings and the subscription frames, built once per symbol,
+// live out of line.
+//
+// A policy provides:
+//   NAME                 "spot" / "futures": journal prefix, log label
+//   HAS_ORDERS           whether levels carry an order count
+//   Entry                trivially copyable level: price, volume[, orders]
+//   SYMBOLS_ENV          variable listing extra symbols to track
+//   FANOUT_ENV           variable with the multicast group:port of the fan-out
+//   GROUPINGS_ENV        variable with the price steps of the grouped views
+//   symbol(base, quote)  exchange name of a pair
+//   connection(incr)     SubscriptionManager::Venue for diff (incr) or full depth
+//   snapshots(ioc)       REST depth source for resynchronising diff streams
+//   other(text)          replies and errors the fast parser does not handle
+//   apply(...)           parse -> sequence -> apply of one frame
+//   resync(...)          rebuild of a diff stream from a snapshot that arrived
+//
+
+#ifndef MEXC_VENUES_H
+#define MEXC_VENUES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "MarketFeed.h"
+#include "SnapshotSource.h"
+#include "SubscriptionManager.h"
+
+struct SpotVenue {
+    static constexpr const char* NAME = "spot";
+    static constexpr bool HAS_ORDERS = false;
+    static constexpr const char* SYMBOLS_ENV = "MEXC_SPOT_SYMBOLS";
+    static constexpr const char* FANOUT_ENV = "MEXC_SPOT_FANOUT";
+    static constexpr const char* GROUPINGS_ENV = "MEXC_SPOT_GROUPINGS";
+
+    struct Entry {
+        int64_t price;         // Price in ticks of 10^-priceDecimals
+        int64_t volume;        // Volume in ticks of 10^-qtyDecimals
+    };
+
+    // e.g. ETHUSDT
+    static std::string symbol(std::string_view base, std::string_view quote);
+    static SubscriptionManager::Venue connection(bool incrementalDepth);
+    static AsyncSnapshotSource snapshots(boost::asio::io_context& ioc);
+    // Frames that are not market data: subscription replies, errors, pongs
+    static void other(std::string_view text);
+
+    static FeedResult apply(FeedState& feed, std::string_view text, const SnapshotSource& snapshots,
+                            size_t depth, FeedTiming* timing) {
+        return applySpotFrame(feed, text, snapshots, depth, timing);
+    }
+    static FeedResult resync(FeedState& feed, const SnapshotSource& snapshots) {
+        return resyncSpotBook(feed, snapshots);
+    }
+};
+static_assert(sizeof(SpotVenue::Entry) == 16, "Entry should stay a compact POD");
+
+struct FuturesVenue {
+    static constexpr const char* NAME = "futures";
+    static constexpr bool HAS_ORDERS = true;
+    static constexpr const char* SYMBOLS_ENV = "MEXC_FUTURES_SYMBOLS";
+    static constexpr const char* FANOUT_ENV = "MEXC_FUTURES_FANOUT";
+    static constexpr const char* GROUPINGS_ENV = "MEXC_FUTURES_GROUPINGS";
+
+    struct Entry {
+        int64_t price;          // Price in ticks of 10^-priceDecimals
+        int64_t volume;         // Volume in ticks of 10^-qtyDecimals
+        int32_t orders;         // Number of orders
+    };
+
+    // e.g. ETH_USDT
+    static std::string symbol(std::string_view base, std::string_view quote);
+    static SubscriptionManager::Venue connection(bool incrementalDepth);
+    static AsyncSnapshotSource snapshots(boost::asio::io_context& ioc);
+    // Frames that are not market data: subscription replies, errors, pongs
+    static void other(std::string_view text);
+
+    // Full depth frames carry 20 levels themselves, so depth is not needed
+    static FeedResult apply(FeedState& feed, std::string_view text, const SnapshotSource& snapshots,
+                            size_t, FeedTiming* timing) {
+        return applyFuturesFrame(feed, text, snapshots, timing);
+    }
+    static FeedResult resync(FeedState& feed, const SnapshotSource& snapshots) {
+        return resyncFuturesBook(feed, snapshots);
+    }
+};
+static_assert(sizeof(FuturesVenue::Entry) == 24, "Entry should stay a compact POD");
+
+#endif //MEXC_VENUES_H
@@ -0,0 +1,182 @@
+#include "MulticastFanout.h"
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <boost/asio/ip/multicast.hpp>
+#include <boost/asio/write.hpp>
+
+namespace net = boost::asio;
+using net::ip::tcp;
+using net::ip::udp;
+
+struct MulticastFanout::Channel {
+    explicit Channel(net::io_context& ioc) : socket(ioc) {}
+
+    udp::socket socket;
+    uint16_t index = 0;
+    uint64_t sequence = 0;
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> dropped{0};
+    alignas(8) char packet[FANOUT_MAX_PACKET];
+};
+
+MulticastFanout::MulticastFanout(net::io_context& ioc, std::string venue, size_t channels, Options options,
+                                 SnapshotProvider snapshots)
+    : m_venue(std::move(venue)),
+      m_options(std::move(options)),
+      m_snapshots(std::move(snapshots)),
+      m_acceptor(ioc) {
+    for (size_t i = 0; i < std::max<size_t>(channels, 1); i++) {
+        m_channels.push_back(std::make_unique<Channel>(ioc));
+        m_channels.back()->index = static_cast<uint16_t>(i);
+    }
+}
+
+MulticastFanout::~MulticastFanout() = default;
+
+bool MulticastFanout::open() {
+    boost::system::error_code ec;
+    auto group = net::ip::make_address_v4(m_options.group, ec);
+    auto interfaceAddress = ec ? net::ip::address_v4() : net::ip::make_address_v4(m_options.interfaceAddress, ec);
+    if (ec) {
+        std::cerr << "Fan-out " << m_venue << ": bad address: " << ec.message() << std::endl;
+        return false;
+    }
+    m_destination = udp::endpoint(group, m_options.port);
+
+    for (auto& channel : m_channels) {
+        udp::socket& socket = channel->socket;
+        socket.open(udp::v4(), ec);
+        if (!ec && group.is_multicast()) {
+            socket.set_option(net::ip::multicast::outbound_interface(interfaceAddress), ec);
+            if (!ec) socket.set_option(net::ip::multicast::hops(m_options.ttl), ec);
+            if (!ec) socket.set_option(net::ip::multicast::enable_loopback(true), ec);
+        }
+        if (!ec) socket.non_blocking(true, ec);
+        if (ec) {
+            std::cerr << "Fan-out " << m_venue << ": UDP socket: " << ec.message() << std::endl;
+            return false;
+        }
+    }
+
+    tcp::endpoint listen(interfaceAddress, m_options.port);
+    m_acceptor.open(listen.protocol(), ec);
+    if (!ec) m_acceptor.set_option(net::socket_base::reuse_address(true), ec);
+    if (!ec) m_acceptor.bind(listen, ec);
+    if (!ec) m_acceptor.listen(net::socket_base::max_listen_connections, ec);
+    if (ec) {
+        std::cerr << "Fan-out " << m_venue << ": recovery listener on " << listen << ": " << ec.message() << std::endl;
+        return false;
+    }
+    accept();
+
+    std::cout << "Fanning out " << m_venue << " books to udp://" << m_destination << " (" << m_channels.size()
+              << " channels), recovery on tcp://" << listen << std::endl;
+    return true;
+}
+
+void MulticastFanout::send(size_t channelIndex, const BookRecord* records, size_t count) {
+    Channel& channel = *m_channels[channelIndex % m_channels.size()];
+    while (count > 0) {
+        size_t batch = std::min(count, FANOUT_MAX_RECORDS);
+        std::memcpy(channel.packet + sizeof(FanoutPacketHeader), records, batch * sizeof(BookRecord));
+        flush(channel, batch);
+        records += batch;
+        count -= batch;
+    }
+}
+
+void MulticastFanout::flush(Channel& channel, size_t count) {
+    FanoutPacketHeader header = {
+        .magic = FANOUT_PACKET_MAGIC,
+        .channel = channel.index,
+        .count = static_cast<uint16_t>(count),
+        .sequence = ++channel.sequence,
+        .sendNs = steadyNowNs(),
+    };
+    std::memcpy(channel.packet, &header, sizeof(header));
+
+    // The sequence advances even when the kernel refuses the datagram, so
+    // subscribers see the loss
+    boost::system::error_code ec;
+    channel.socket.send_to(net::buffer(channel.packet, sizeof(header) + count * sizeof(BookRecord)), m_destination,
+                           0, ec);
+    if (ec) {
+        channel.dropped.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        channel.sent.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+uint64_t MulticastFanout::sentPackets() const {
+    uint64_t total = 0;
+    for (const auto& channel : m_channels) total += channel->sent.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t MulticastFanout::droppedPackets() const {
+    uint64_t total = 0;
+    for (const auto& channel : m_channels) total += channel->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
+void MulticastFanout::accept() {
+    m_acceptor.async_accept([this](const boost::system::error_code& ec, tcp::socket socket) {
+        if (ec) {
+            if (ec != net::error::operation_aborted) {
+                std::cerr << "Fan-out " << m_venue << ": accept: " << ec.message() << std::endl;
+                accept();
+            }
+            return;
+        }
+
+        std::vector<BookSymbolName> symbols;
+        std::vector<BookRecord> records;
+        m_snapshots(symbols, records);
+        FanoutRecoveryHeader header = {
+            .magic = FANOUT_RECOVERY_MAGIC,
+            .channelCount = static_cast<uint32_t>(m_channels.size()),
+            .symbolCount = static_cast<uint32_t>(symbols.size()),
+            .recordCount = static_cast<uint32_t>(records.size()),
+        };
+
+        // One buffer for the whole reply; it lives until the write finishes
+        auto reply = std::make_shared<std::vector<char>>(
+            sizeof(header) + symbols.size() * sizeof(BookSymbolName) + records.size() * sizeof(BookRecord));
+        char* out = reply->data();
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        if (!symbols.empty()) std::memcpy(out, symbols.data(), symbols.size() * sizeof(BookSymbolName));
+        out += symbols.size() * sizeof(BookSymbolName);
+        if (!records.empty()) std::memcpy(out, records.data(), records.size() * sizeof(BookRecord));
+
+        auto connection = std::make_shared<tcp::socket>(std::move(socket));
+        net::async_write(*connection, net::buffer(*reply),
+                         [connection, reply](const boost::system::error_code&, size_t) {
+            boost::system::error_code ignored;
+            connection->shutdown(tcp::socket::shutdown_both, ignored);
+        });
+        accept();
+    });
+}
+
+bool fanoutFromEnv(const char* envVar, MulticastFanout::Options& options) {
+    const char* value = std::getenv(envVar);
+    if (value == nullptr || *value == '\0') return false;
+
+    std::string spec = value;
+    size_t colon = spec.rfind(':');
+    long port = colon == std::string::npos ? 0 : std::strtol(spec.c_str() + colon + 1, nullptr, 10);
+    if (colon == 0 || port <= 0 || port > 65535) {
+        std::cerr << envVar << ": unsupported fan-out '" << spec << "', expected group:port" << std::endl;
+        return false;
+    }
+    options.group = spec.substr(0, colon);
+    options.port = static_cast<uint16_t>(port);
+    if (const char* address = std::getenv("MEXC_FANOUT_INTERFACE")) options.interfaceAddress = address;
+    return true;
+}
@@ -0,0 +1,79 @@
+//
+// Fan-out of normalized book updates to other machines: UDP multicast for
+// the live stream, TCP for recovery (wire format in FanoutProtocol.h).
+//
+// One JSON decode in the feed becomes fixed-layout records any number of
+// subscribers read without parsing. Every channel (shard worker) has its own
+// socket and sequence and is only sent to by its worker, so the send path
+// takes no lock; sockets are non-blocking and a datagram the kernel cannot
+// take right away is counted as dropped rather than stalling the worker.
+// Subscribers see the gap in the sequence and recover over TCP.
+//
+// Recovery connections are served on the io thread with a snapshot taken
+// there by the SnapshotProvider.
+//
+
+#ifndef MULTICAST_FANOUT_H
+#define MULTICAST_FANOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
+
+#include "FanoutProtocol.h"
+
+class MulticastFanout {
+public:
+    struct Options {
+        std::string group = "239.255.0.1";      // Multicast group the datagrams go to
+        uint16_t port = 30001;                  // UDP destination and TCP recovery port
+        std::string interfaceAddress = "127.0.0.1"; // Outgoing interface, and where recovery listens
+        int ttl = 1;                            // Hops; 1 keeps the stream on the local network
+    };
+
+    // Fills the symbol table and a snapshot of every book; runs on the io thread
+    using SnapshotProvider = std::function<void(std::vector<BookSymbolName>& symbols, std::vector<BookRecord>& records)>;
+
+    MulticastFanout(boost::asio::io_context& ioc, std::string venue, size_t channels, Options options,
+                    SnapshotProvider snapshots);
+    ~MulticastFanout();
+
+    MulticastFanout(const MulticastFanout&) = delete;
+    MulticastFanout& operator=(const MulticastFanout&) = delete;
+
+    // Opens the sockets and starts accepting recovery connections
+    bool open();
+
+    // Sends the records of one update, split into as few datagrams as fit.
+    // Only the owner of `channel` may call it.
+    void send(size_t channel, const BookRecord* records, size_t count);
+
+    uint64_t sentPackets() const;
+    uint64_t droppedPackets() const;
+
+private:
+    struct Channel;
+    void accept();
+    void flush(Channel& channel, size_t count);
+
+    std::string m_venue;
+    Options m_options;
+    SnapshotProvider m_snapshots;
+    boost::asio::ip::udp::endpoint m_destination;
+    std::vector<std::unique_ptr<Channel>> m_channels;
+    boost::asio::ip::tcp::acceptor m_acceptor;
+};
+
+// Reads "group:port" from envVar into options (the interface from
+// MEXC_FANOUT_INTERFACE when set). False when the variable is unset or bad.
+bool fanoutFromEnv(const char* envVar, MulticastFanout::Options& options);
+
+#endif //MULTICAST_FANOUT_H
@@ -0,0 +1,424 @@
+#include "OrderBookEngine.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+OrderBookEngine::OrderBookEngine(size_t capacity) {
+    size_t slots = std::bit_ceil(capacity < 64 ? size_t{64} : capacity);
+    m_mask = slots - 1;
+    for (size_t i = 0; i < 2; i++) {
+        m_qty[i].assign(slots, 0);
+        m_orders[i].assign(slots, 0);
+        m_bits[i].assign(slots / 64, 0);
+    }
+}
+
+// Highest set position in [low, from] of a bitmap ring holding the positions
+// [low, low + mask], or NO_PRICE
+static int64_t highestSet(const std::vector<uint64_t>& bits, size_t mask, int64_t low, int64_t from) {
+    while (from >= low) {
+        size_t slot = static_cast<size_t>(from) & mask;
+        size_t bit = slot & 63;
+        uint64_t word = bits[slot >> 6] & (bit == 63 ? ~0ULL : ((1ULL << (bit + 1)) - 1));
+        if (word) {
+            int high = 63 - std::countl_zero(word);
+            int64_t position = from - static_cast<int64_t>(bit - high);
+            // Bits below `low` belong to the top of the ring, not to us
+            return position >= low ? position : OrderBookEngine::NO_PRICE;
+        }
+        from -= static_cast<int64_t>(bit) + 1;
+    }
+    return OrderBookEngine::NO_PRICE;
+}
+
+// Lowest set position in [from, high] of a bitmap ring holding the positions
+// [high - mask, high], or NO_PRICE
+static int64_t lowestSet(const std::vector<uint64_t>& bits, size_t mask, int64_t high, int64_t from) {
+    while (from <= high) {
+        size_t slot = static_cast<size_t>(from) & mask;
+        size_t bit = slot & 63;
+        uint64_t word = bits[slot >> 6] & (~0ULL << bit);
+        if (word) {
+            int low = std::countr_zero(word);
+            int64_t position = from + static_cast<int64_t>(low - bit);
+            return position <= high ? position : OrderBookEngine::NO_PRICE;
+        }
+        from += static_cast<int64_t>(64 - bit);
+    }
+    return OrderBookEngine::NO_PRICE;
+}
+
+int64_t OrderBookEngine::findBelow(Side side, int64_t from) const {
+    if (m_anchor == NO_PRICE) return NO_PRICE;
+    const int64_t top = m_anchor + static_cast<int64_t>(m_mask);
+    return highestSet(m_bits[idx(side)], m_mask, m_anchor, std::min(from, top));
+}
+
+int64_t OrderBookEngine::findAbove(Side side, int64_t from) const {
+    if (m_anchor == NO_PRICE) return NO_PRICE;
+    const int64_t top = m_anchor + static_cast<int64_t>(m_mask);
+    return lowestSet(m_bits[idx(side)], m_mask, top, std::max(from, m_anchor));
+}
+
+// Buckets of the lowest and highest price in the window bound the scans: the
+// bucket ring is sized to hold all of them
+int64_t OrderBookEngine::findBucketBelow(const Grouping& group, Side side, int64_t from) const {
+    if (m_anchor == NO_PRICE) return NO_PRICE;
+    int64_t low = group.bucketOf(Side::Bid, m_anchor);
+    return highestSet(group.bits[idx(side)], group.mask, low, std::min(from, low + static_cast<int64_t>(group.mask)));
+}
+
+int64_t OrderBookEngine::findBucketAbove(const Grouping& group, Side side, int64_t from) const {
+    if (m_anchor == NO_PRICE) return NO_PRICE;
+    int64_t low = group.bucketOf(Side::Bid, m_anchor);
+    int64_t high = low + static_cast<int64_t>(group.mask);
+    return lowestSet(group.bits[idx(side)], group.mask, high, std::max(from, low));
+}
+
+void OrderBookEngine::setSlot(Side side, int64_t price, int64_t qty, int32_t orders) {
+    size_t i = idx(side);
+    size_t slot = slotOf(price);
+    uint64_t bit = 1ULL << (slot & 63);
+    uint64_t& word = m_bits[i][slot >> 6];
+
+    // Repeating a level as it is changes nothing, not even the versions
+    if ((word & bit) && m_qty[i][slot] == qty && m_orders[i][slot] == orders) return;
+
+    bool added = !(word & bit);
+    if (added) {
+        word |= bit;
+        (side == Side::Bid ? m_bidCount : m_askCount)++;
+    }
+    // Free slots hold zero, so this covers new levels too
+    m_totalQty[i] += qty - m_qty[i][slot];
+    if (!m_groupings.empty()) group(side, price, qty - m_qty[i][slot], orders - m_orders[i][slot], added ? 1 : 0);
+    touch(side, price);
+    m_qty[i][slot] = qty;
+    m_orders[i][slot] = orders;
+
+    if (side == Side::Bid) {
+        if (m_bestBid == NO_PRICE || price > m_bestBid) m_bestBid = price;
+    } else {
+        if (m_bestAsk == NO_PRICE || price < m_bestAsk) m_bestAsk = price;
+    }
+}
+
+void OrderBookEngine::clearSlot(Side side, int64_t price) {
+    size_t i = idx(side);
+    size_t slot = slotOf(price);
+    uint64_t bit = 1ULL << (slot & 63);
+    uint64_t& word = m_bits[i][slot >> 6];
+    if (!(word & bit)) return;
+
+    word &= ~bit;
+    m_totalQty[i] -= m_qty[i][slot];
+    if (!m_groupings.empty()) group(side, price, -m_qty[i][slot], -m_orders[i][slot], -1);
+    touch(side, price);
+    m_qty[i][slot] = 0;
+    m_orders[i][slot] = 0;
+
+    if (side == Side::Bid) {
+        m_bidCount--;
+        if (price == m_bestBid) m_bestBid = m_bidCount ? findBelow(Side::Bid, price - 1) : NO_PRICE;
+    } else {
+        m_askCount--;
+        if (price == m_bestAsk) m_bestAsk = m_askCount ? findAbove(Side::Ask, price + 1) : NO_PRICE;
+    }
+}
+
+bool OrderBookEngine::update(Side side, int64_t price, int64_t qty, int32_t orders) {
+    if (!inWindow(price)) {
+        // Nothing to delete outside the window
+        if (qty == 0) return true;
+
+        bool improvesBest = side == Side::Bid
+            ? (m_bestBid == NO_PRICE || price > m_bestBid)
+            : (m_bestAsk == NO_PRICE || price < m_bestAsk);
+
+        if (m_anchor == NO_PRICE || empty() || improvesBest) {
+            // The market walked out of the window: follow it
+            recenter(price);
+        } else {
+            // A deep level beyond the far edge of the window
+            m_dropped++;
+            return false;
+        }
+    }
+
+    if (qty == 0) {
+        clearSlot(side, price);
+    } else {
+        setSlot(side, price, qty, orders);
+        maybeRecenter();
+    }
+    return true;
+}
+
+void OrderBookEngine::setBest(Side side, int64_t price, int64_t qty) {
+    if (inWindow(price)) {
+        // Remove own-side levels in front of the new best and crossed levels on the other side
+        if (side == Side::Bid) {
+            while (m_bestBid != NO_PRICE && m_bestBid > price) clearSlot(Side::Bid, m_bestBid);
+            while (m_bestAsk != NO_PRICE && m_bestAsk <= price) clearSlot(Side::Ask, m_bestAsk);
+        } else {
+            while (m_bestAsk != NO_PRICE && m_bestAsk < price) clearSlot(Side::Ask, m_bestAsk);
+            while (m_bestBid != NO_PRICE && m_bestBid >= price) clearSlot(Side::Bid, m_bestBid);
+        }
+    }
+    update(side, price, qty);
+}
+
+void OrderBookEngine::clear() {
+    for (size_t i = 0; i < 2; i++) {
+        auto& bits = m_bits[i];
+        for (size_t w = 0; w < bits.size(); w++) {
+            uint64_t word = bits[w];
+            while (word) {
+                size_t slot = (w << 6) + std::countr_zero(word);
+                m_qty[i][slot] = 0;
+                m_orders[i][slot] = 0;
+                word &= word - 1;
+            }
+            bits[w] = 0;
+        }
+        for (Grouping& group : m_groupings) {
+            auto& groupBits = group.bits[i];
+            for (size_t w = 0; w < groupBits.size(); w++) {
+                for (uint64_t word = groupBits[w]; word; word &= word - 1) {
+                    group.buckets[i][(w << 6) + std::countr_zero(word)] = Bucket{};
+                }
+                groupBits[w] = 0;
+            }
+        }
+    }
+    m_anchor = NO_PRICE;
+    m_bestBid = NO_PRICE;
+    m_bestAsk = NO_PRICE;
+    m_bidCount = 0;
+    m_askCount = 0;
+    m_totalQty[0] = m_totalQty[1] = 0;
+    m_depthDirty[0] = m_depthDirty[1] = true;
+    m_version++;
+    m_trackedVersion++;
+}
+
+void OrderBookEngine::truncate(size_t depth) {
+    for (Side side : {Side::Bid, Side::Ask}) {
+        const bool bid = side == Side::Bid;
+        int64_t price = bid ? m_bestBid : m_bestAsk;
+        for (size_t n = 0; n < depth && price != NO_PRICE; n++) {
+            price = bid ? findBelow(side, price - 1) : findAbove(side, price + 1);
+        }
+        // Levels past the cut never affect the best price, except for depth 0
+        while (price != NO_PRICE) {
+            int64_t next = bid ? findBelow(side, price - 1) : findAbove(side, price + 1);
+            clearSlot(side, price);
+            price = next;
+        }
+    }
+}
+
+size_t OrderBookEngine::rescale(int priceDigits, int qtyDigits) {
+    int64_t priceFactor = 1, qtyFactor = 1;
+    for (int i = 0; i < priceDigits; i++) priceFactor *= 10;
+    for (int i = 0; i < qtyDigits; i++) qtyFactor *= 10;
+
+    struct Level {
+        int64_t price;
+        int64_t qty;
+        int32_t orders;
+    };
+    std::vector<Level> levels[2];
+    for (Side side : {Side::Bid, Side::Ask}) {
+        forEachLevel(side, SIZE_MAX, [&](int64_t price, int64_t qty, int32_t orders) {
+            levels[idx(side)].push_back({price * priceFactor, qty * qtyFactor, orders});
+        });
+    }
+    clear();
+
+    // Best levels first, alternating sides, so the window settles around the
+    // touch and only the deepest levels fall out of it. Recentring on the way
+    // drops levels as well, so the count comes from m_dropped.
+    uint64_t dropped = m_dropped;
+    for (size_t n = 0; n < std::max(levels[0].size(), levels[1].size()); n++) {
+        for (Side side : {Side::Bid, Side::Ask}) {
+            const auto& sideLevels = levels[idx(side)];
+            if (n < sideLevels.size()) update(side, sideLevels[n].price, sideLevels[n].qty, sideLevels[n].orders);
+        }
+    }
+    return static_cast<size_t>(m_dropped - dropped);
+}
+
+uint64_t OrderBookEngine::checksum() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    for (Side side : {Side::Bid, Side::Ask}) {
+        mix(static_cast<uint64_t>(side));
+        forEachLevel(side, SIZE_MAX, [&mix](int64_t price, int64_t qty, int32_t orders) {
+            mix(static_cast<uint64_t>(price));
+            mix(static_cast<uint64_t>(qty));
+            mix(static_cast<uint64_t>(static_cast<uint32_t>(orders)));
+        });
+    }
+    return hash;
+}
+
+int64_t OrderBookEngine::qtyAt(Side side, int64_t price) const {
+    return inWindow(price) ? m_qty[idx(side)][slotOf(price)] : 0;
+}
+
+int32_t OrderBookEngine::ordersAt(Side side, int64_t price) const {
+    return inWindow(price) ? m_orders[idx(side)][slotOf(price)] : 0;
+}
+
+void OrderBookEngine::recenter(int64_t center) {
+    const int64_t size = static_cast<int64_t>(m_mask + 1);
+    int64_t newAnchor = center - size / 2;
+
+    if (m_anchor == NO_PRICE || empty()) {
+        // All slots are already zero
+        m_anchor = newAnchor;
+        return;
+    }
+
+    int64_t shift = newAnchor - m_anchor;
+    if (shift == 0) return;
+
+    // Drop the levels in the part of the old window the new one no longer covers
+    int64_t dropFrom, dropTo;
+    if (shift > 0) {
+        dropFrom = m_anchor;
+        dropTo = std::min(newAnchor, m_anchor + size);
+    } else {
+        dropFrom = std::max(newAnchor + size, m_anchor);
+        dropTo = m_anchor + size;
+    }
+    for (Side side : {Side::Bid, Side::Ask}) {
+        size_t i = idx(side);
+        for (int64_t price = findAbove(side, dropFrom); price != NO_PRICE && price < dropTo;
+             price = findAbove(side, price + 1)) {
+            size_t slot = slotOf(price);
+            m_bits[i][slot >> 6] &= ~(1ULL << (slot & 63));
+            m_totalQty[i] -= m_qty[i][slot];
+            if (!m_groupings.empty()) group(side, price, -m_qty[i][slot], -m_orders[i][slot], -1);
+            touch(side, price);
+            m_qty[i][slot] = 0;
+            m_orders[i][slot] = 0;
+            (side == Side::Bid ? m_bidCount : m_askCount)--;
+            m_dropped++;
+        }
+    }
+
+    m_anchor = newAnchor;
+    m_recenters++;
+    m_bestBid = m_bidCount ? findBelow(Side::Bid, m_anchor + size - 1) : NO_PRICE;
+    m_bestAsk = m_askCount ? findAbove(Side::Ask, m_anchor) : NO_PRICE;
+}
+
+void OrderBookEngine::maybeRecenter() {
+    if (m_bestBid == NO_PRICE || m_bestAsk == NO_PRICE) return;
+
+    // Keep the mid within the middle half of the window
+    const int64_t size = static_cast<int64_t>(m_mask + 1);
+    int64_t mid = m_bestBid + (m_bestAsk - m_bestBid) / 2;
+    int64_t center = m_anchor + size / 2;
+    if (mid - center > size / 4 || center - mid > size / 4) recenter(mid);
+}
+
+void OrderBookEngine::touch(Side side, int64_t price) {
+    size_t i = idx(side);
+    m_version++;
+
+    // Until the next rebuild the edge may be out of date, so every change counts
+    if (m_trackedDepth == 0 || m_depthDirty[i]) {
+        m_trackedVersion++;
+        return;
+    }
+
+    // With the tracked levels full, changes behind the worst of them cannot reach them
+    int64_t edge = m_depthEdge[i];
+    if (edge == NO_PRICE || (side == Side::Bid ? price >= edge : price <= edge)) {
+        m_depthDirty[i] = true;
+        m_trackedVersion++;
+    }
+}
+
+void OrderBookEngine::setTrackedDepth(size_t depth) {
+    m_trackedDepth = depth;
+    for (size_t i = 0; i < 2; i++) {
+        m_depth[i].cumulative.assign(depth, 0);
+        m_depthDirty[i] = true;
+    }
+}
+
+void OrderBookEngine::rebuildDepth(Side side) const {
+    size_t i = idx(side);
+    DepthCurve& curve = m_depth[i];
+    curve.levels = 0;
+    curve.maxQty = 0;
+
+    int64_t sum = 0;
+    int64_t last = NO_PRICE;
+    forEachLevel(side, m_trackedDepth, [&](int64_t price, int64_t qty, int32_t) {
+        sum += qty;
+        curve.cumulative[curve.levels++] = sum;
+        if (qty > curve.maxQty) curve.maxQty = qty;
+        last = price;
+    });
+
+    m_depthEdge[i] = curve.levels == m_trackedDepth ? last : NO_PRICE;
+    m_depthDirty[i] = false;
+}
+
+void OrderBookEngine::setGroupings(const std::vector<int64_t>& ticks) {
+    m_groupings.clear();
+    for (int64_t width : ticks) {
+        if (width < 2) continue;
+        // Every bucket a price in the window rounds to, either way
+        size_t buckets = (m_mask + 1) / static_cast<size_t>(width) + 3;
+        size_t slots = std::bit_ceil(buckets < 64 ? size_t{64} : buckets);
+        Grouping group{width, slots - 1, {}, {}};
+        for (size_t i = 0; i < 2; i++) {
+            group.buckets[i].assign(slots, Bucket{});
+            group.bits[i].assign(slots / 64, 0);
+        }
+        m_groupings.push_back(std::move(group));
+    }
+
+    for (Side side : {Side::Bid, Side::Ask}) {
+        forEachLevel(side, SIZE_MAX, [this, side](int64_t price, int64_t qty, int32_t orders) {
+            group(side, price, qty, orders, 1);
+        });
+    }
+}
+
+void OrderBookEngine::group(Side side, int64_t price, int64_t qty, int32_t orders, int32_t levels) {
+    size_t i = idx(side);
+    for (Grouping& grouping : m_groupings) {
+        size_t slot = static_cast<size_t>(grouping.bucketOf(side, price)) & grouping.mask;
+        Bucket& bucket = grouping.buckets[i][slot];
+        bucket.qty += qty;
+        bucket.orders += orders;
+        if (levels == 0) continue;
+
+        bucket.levels += levels;
+        uint64_t bit = 1ULL << (slot & 63);
+        if (bucket.levels) {
+            grouping.bits[i][slot >> 6] |= bit;
+        } else {
+            grouping.bits[i][slot >> 6] &= ~bit;
+        }
+    }
+}
+
+const DepthCurve& OrderBookEngine::depth(Side side) const {
+    size_t i = idx(side);
+    if (m_depthDirty[i] && m_trackedDepth) rebuildDepth(side);
+    return m_depth[i];
+}
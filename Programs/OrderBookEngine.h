@@ -0,0 +1,204 @@
+//
+// Price ladder order book keyed by tick offset.
+//
+// Levels live in a power-of-two ring of slots covering the price window
+// [anchor, anchor + capacity). A price maps to slot (price & mask), so an
+// update or delete is a single array write. Occupied slots are tracked in a
+// bitmap per side, which keeps best bid/ask maintenance and top-N walks to a
+// few word scans. When the market walks out of the window the anchor is moved
+// and the levels that fall off the far end are dropped.
+//
+// Each side also keeps a running volume total, and optionally the prefix sums
+// and largest level of its `trackedDepth` best levels. Those are rebuilt only
+// after a change inside the tracked levels, so reading them is O(1) however
+// often the book is drawn.
+//
+// Groupings are coarser ladders of the same book: buckets of a fixed number
+// of ticks, laid out like the levels (a ring with an occupancy bitmap). Every
+// level change adds its difference into one bucket of each grouping, so all
+// of them are current at once and reading one never sums levels. Bids fall
+// into the bucket at or below their price and asks at or above, so the two
+// sides never share a bucket.
+//
+
+#ifndef ORDERBOOK_ENGINE_H
+#define ORDERBOOK_ENGINE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+enum class Side : uint8_t { Bid, Ask };
+
+// Aggregates over the best levels of one side
+struct DepthCurve {
+    size_t levels = 0;                  // Levels covered, up to the tracked depth
+    int64_t maxQty = 0;                 // Largest of those levels
+    std::vector<int64_t> cumulative;    // cumulative[i]: qty of levels 0..i
+
+    int64_t total() const { return levels ? cumulative[levels - 1] : 0; }
+};
+
+class OrderBookEngine {
+public:
+    static constexpr int64_t NO_PRICE = INT64_MIN;
+
+    // capacity is rounded up to a power of two (minimum 64 slots)
+    explicit OrderBookEngine(size_t capacity = 8192);
+
+    // Sets a level; qty == 0 removes it. Returns false when the price was
+    // outside the window and could not be placed.
+    bool update(Side side, int64_t price, int64_t qty, int32_t orders = 0);
+
+    // Sets the best level of a side from a top-of-book message and removes any
+    // stale levels that would sit in front of it.
+    void setBest(Side side, int64_t price, int64_t qty);
+
+    // Removes all levels; cost is proportional to the number of levels
+    void clear();
+
+    // Keeps only the `depth` best levels on each side
+    void truncate(size_t depth);
+
+    // Moves the book to a finer scale: prices are multiplied by
+    // 10^priceDigits and quantities by 10^qtyDigits. The window holds as many
+    // ticks as before, so levels that no longer fit around the best prices
+    // are dropped; returns how many. Groupings keep their width in ticks.
+    size_t rescale(int priceDigits, int qtyDigits);
+
+    int64_t bestBid() const { return m_bestBid; }
+    int64_t bestAsk() const { return m_bestAsk; }
+    size_t bidCount() const { return m_bidCount; }
+    size_t askCount() const { return m_askCount; }
+    bool empty() const { return m_bidCount == 0 && m_askCount == 0; }
+
+    // FNV-1a over every level, bids then asks from the best price outward.
+    // Books holding the same levels hash the same.
+    uint64_t checksum() const;
+
+    // Incremented by every change to the book
+    uint64_t version() const { return m_version; }
+    // Incremented by the changes that reach the tracked levels; by every
+    // change when no depth is tracked
+    uint64_t trackedVersion() const { return m_trackedVersion; }
+
+    // Volume of every level of a side, kept up to date on each change
+    int64_t totalQty(Side side) const { return m_totalQty[idx(side)]; }
+
+    // Tracks the `depth` best levels of each side for depth(); 0 turns it off
+    void setTrackedDepth(size_t depth);
+    size_t trackedDepth() const { return m_trackedDepth; }
+
+    // Aggregates of the tracked levels, rebuilt on first read after a change
+    // that reached them
+    const DepthCurve& depth(Side side) const;
+
+    // Keeps the book summed into buckets of each width (in price ticks, > 1)
+    // as well. Replaces the previous groupings; the new ones are filled from
+    // the levels already in the book.
+    void setGroupings(const std::vector<int64_t>& ticks);
+    size_t groupingCount() const { return m_groupings.size(); }
+    int64_t groupingTicks(size_t grouping) const { return m_groupings[grouping].ticks; }
+
+    int64_t qtyAt(Side side, int64_t price) const;
+    int32_t ordersAt(Side side, int64_t price) const;
+
+    size_t capacity() const { return m_qty[0].size(); }
+    int64_t anchor() const { return m_anchor; }
+    uint64_t recenterCount() const { return m_recenters; }
+    uint64_t droppedCount() const { return m_dropped; }
+
+    // Walks up to maxLevels levels from the best price outward, calling
+    // fn(price, qty, orders) for each.
+    template <typename Fn>
+    void forEachLevel(Side side, size_t maxLevels, Fn&& fn) const {
+        int64_t price = side == Side::Bid ? m_bestBid : m_bestAsk;
+        for (size_t n = 0; n < maxLevels && price != NO_PRICE; n++) {
+            size_t slot = slotOf(price);
+            fn(price, m_qty[idx(side)][slot], m_orders[idx(side)][slot]);
+            price = side == Side::Bid ? findBelow(side, price - 1) : findAbove(side, price + 1);
+        }
+    }
+
+    // Walks up to maxLevels buckets of a grouping from the best outward,
+    // calling fn(price, qty, orders) with the price the bucket stands for
+    template <typename Fn>
+    void forEachGroupedLevel(size_t grouping, Side side, size_t maxLevels, Fn&& fn) const {
+        const Grouping& group = m_groupings[grouping];
+        int64_t best = side == Side::Bid ? m_bestBid : m_bestAsk;
+        int64_t bucket = best == NO_PRICE ? NO_PRICE : group.bucketOf(side, best);
+        for (size_t n = 0; n < maxLevels && bucket != NO_PRICE; n++) {
+            const Bucket& entry = group.buckets[idx(side)][static_cast<size_t>(bucket) & group.mask];
+            fn(bucket * group.ticks, entry.qty, entry.orders);
+            bucket = side == Side::Bid ? findBucketBelow(group, side, bucket - 1)
+                                       : findBucketAbove(group, side, bucket + 1);
+        }
+    }
+
+private:
+    struct Bucket {
+        int64_t qty = 0;
+        int32_t orders = 0;
+        int32_t levels = 0;             // Levels summed in; the bucket is shown while > 0
+    };
+
+    struct Grouping {
+        int64_t ticks;
+        size_t mask;                    // Of the bucket ring, which covers the whole level window
+        std::vector<Bucket> buckets[2];
+        std::vector<uint64_t> bits[2];
+
+        // Bucket number of a price: rounded down for bids, up for asks
+        int64_t bucketOf(Side side, int64_t price) const {
+            int64_t floor = price / ticks - (price % ticks < 0 ? 1 : 0);
+            return side == Side::Bid || floor * ticks == price ? floor : floor + 1;
+        }
+    };
+
+    static constexpr size_t idx(Side side) { return side == Side::Bid ? 0 : 1; }
+    size_t slotOf(int64_t price) const { return static_cast<size_t>(price) & m_mask; }
+    bool inWindow(int64_t price) const {
+        return m_anchor != NO_PRICE && price >= m_anchor && price < m_anchor + static_cast<int64_t>(m_mask + 1);
+    }
+
+    // Highest occupied price <= from / lowest occupied price >= from, or NO_PRICE
+    int64_t findBelow(Side side, int64_t from) const;
+    int64_t findAbove(Side side, int64_t from) const;
+    // The same over the buckets of a grouping
+    int64_t findBucketBelow(const Grouping& group, Side side, int64_t from) const;
+    int64_t findBucketAbove(const Grouping& group, Side side, int64_t from) const;
+
+    void setSlot(Side side, int64_t price, int64_t qty, int32_t orders);
+    void clearSlot(Side side, int64_t price);
+    void recenter(int64_t center);
+    void maybeRecenter();
+    void touch(Side side, int64_t price);
+    void rebuildDepth(Side side) const;
+    // Adds a level's change into its bucket of every grouping
+    void group(Side side, int64_t price, int64_t qty, int32_t orders, int32_t levels);
+
+    std::vector<int64_t> m_qty[2];
+    std::vector<int32_t> m_orders[2];
+    std::vector<uint64_t> m_bits[2];
+
+    size_t m_mask;
+    int64_t m_anchor = NO_PRICE;
+    int64_t m_bestBid = NO_PRICE;
+    int64_t m_bestAsk = NO_PRICE;
+    size_t m_bidCount = 0;
+    size_t m_askCount = 0;
+    uint64_t m_recenters = 0;
+    uint64_t m_dropped = 0;
+
+    uint64_t m_version = 0;
+    uint64_t m_trackedVersion = 0;
+    int64_t m_totalQty[2] = {0, 0};
+    size_t m_trackedDepth = 0;
+    mutable DepthCurve m_depth[2];
+    mutable bool m_depthDirty[2] = {true, true};
+    mutable int64_t m_depthEdge[2] = {NO_PRICE, NO_PRICE};  // Worst tracked price while the side has more levels
+
+    std::vector<Grouping> m_groupings;
+};
+
+#endif //ORDERBOOK_ENGINE_H
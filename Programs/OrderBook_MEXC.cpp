@@ -0,0 +1,802 @@
+//
+// Created by exetrading on 2025-01-07.
+//
+
+#include "OrderBook_MEXC.h"
+#include "MEXC_Feed.h"
+#include "FixedPoint.h"
+#include "BookSnapshot.h"
+#include "BookMetrics.h"
+#include "LatencyHistogram.h"
+#include "Indicators.h"
+#include "RowRenderCache.h"
+#include "LineBatch.h"
+#include "LiquidityHeatmap.h"
+
+
+#include <iostream>
+#include <string>
+#include <raylib.h>
+#include <memory>
+#include <atomic>
+#include <span>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cmath>
+
+// Market shown in the window; the topbar button or Tab switches it (render thread)
+enum class ViewVenue { Spot, Futures };
+ViewVenue g_viewVenue = ViewVenue::Futures;
+
+// The pair in the inputs on each market, once subscribed
+std::atomic<SpotFeed::Symbol*> g_spotView = nullptr;
+std::atomic<FuturesFeed::Symbol*> g_futuresView = nullptr;
+
+SymbolScale g_scale;  // Scale of the snapshot currently being drawn
+int g_shownPriceDecimals = 0;   // Price digits of the rows being drawn; fewer when grouped
+int64_t g_shownGroupTicks = 0;  // Bucket width of the rows being drawn, 0 for raw levels
+
+char g_baseInput[32] = "ETH";
+char g_quoteInput[32] = "USDT";
+std::atomic<bool> g_shouldRefresh = false;
+
+void requestRefresh();  // Defined with the connection code below
+
+bool g_showLatency = false;         // F3 toggles the overlay
+bool g_showHeatmap = false;         // F4 swaps the book rows for the liquidity history
+uint32_t g_grouping = 0;            // F5 cycles the rows: raw levels, then each grouping step that fits the pair
+
+// Price x time history of each market's shown pair, fed while the other is shown too
+LiquidityHeatmap g_spotHeatmap;
+LiquidityHeatmap g_futuresHeatmap;
+int64_t g_presentPendingNs = 0;     // Receive stamp of a drawn book not yet presented (render thread)
+LatencyStats* g_presentLatency = nullptr;   // Market of that book
+
+// What the window last drew, for RL_MEXC_Orderbook_Changed() (render thread).
+// Both markets count: the other one moves the basis.
+ViewVenue g_drawnVenue = ViewVenue::Futures;
+const void* g_drawnSpot = nullptr;
+const void* g_drawnFutures = nullptr;
+uint64_t g_drawnSpotWrites = 0;
+uint64_t g_drawnFuturesWrites = 0;
+
+// Price digits worth showing for buckets of groupTicks: a width of 10 ticks
+// makes the last one always 0
+inline int shownPriceDecimals(int priceDecimals, int64_t groupTicks) {
+    int decimals = std::max(priceDecimals, 0);
+    for (int64_t ticks = groupTicks; ticks >= 10 && ticks % 10 == 0 && decimals > 0; ticks /= 10) decimals--;
+    return decimals;
+}
+
+template <typename Entry>
+inline float priceOf(const Entry& entry) {
+    return static_cast<float>(fixedToDouble(entry.price, g_scale.priceDecimals));
+}
+
+template <typename Entry>
+inline float volumeOf(const Entry& entry) {
+    return static_cast<float>(fixedToDouble(entry.volume, g_scale.qtyDecimals));
+}
+
+template <typename Entry>
+void DrawOrderBookHeatmap(
+    std::span<const Entry> orders,
+    int startX, int width, int topbarHeight,
+    const OrderBookMetrics& metrics, bool isBid)
+{
+    if (orders.empty()) return;
+
+    // Largest level, kept up to date by the book engine
+    float maxVolume = isBid ? metrics.maxBidVolume : metrics.maxAskVolume;
+
+    // Updated heatmap colors with better transparency
+    const Color heatmapColors[] = {
+        isBid ? Color{0, 0, 128, 25} : Color{128, 0, 0, 25},    // High volume
+        isBid ? Color{0, 0, 96, 20} : Color{96, 0, 0, 20},      // Medium volume
+        isBid ? Color{0, 0, 64, 15} : Color{64, 0, 0, 15}       // Low volume
+    };
+
+    const int ROW_HEIGHT = 30;
+
+    for (size_t i = 0; i < orders.size(); i++) {
+        float volume = volumeOf(orders[i]);
+        float y = topbarHeight + (i * ROW_HEIGHT);
+
+        // Calculate intensity based on volume
+        float intensity = volume / maxVolume;
+
+        // Select color based on intensity
+        int colorIndex = std::min(
+            static_cast<int>(intensity * (sizeof(heatmapColors)/sizeof(heatmapColors[0]) - 1)),
+            static_cast<int>(sizeof(heatmapColors)/sizeof(heatmapColors[0]) - 1)
+        );
+
+        // Draw heatmap overlay
+        DrawRectangle(startX, y, width, ROW_HEIGHT, heatmapColors[colorIndex]);
+    }
+}
+
+// Function to render and handle buttons
+void RL_MEXC_Orderbook_Topbar() {
+    const Color HEADER_BG = {20, 20, 30, 255};
+    const Color INPUT_BG = {33, 33, 33, 255};
+    const Color INPUT_ACTIVE_BG = {45, 45, 45, 255};
+    const Color BUTTON_COLOR = {40, 80, 120, 255};
+    const Color BUTTON_HOVER_COLOR = {50, 100, 150, 255};
+
+    // Draw the background
+    DrawRectangle(0, 0, GetScreenWidth(), 40, HEADER_BG);
+
+    // Input dimensions
+    const int INPUT_WIDTH = 100;
+    const int INPUT_HEIGHT = 30;
+    const int INPUT_PADDING = 10;
+    const int START_X = 20;
+
+    // Define input rectangles
+    Rectangle baseRect = {START_X, 5, INPUT_WIDTH, INPUT_HEIGHT};
+    Rectangle quoteRect = {START_X + INPUT_WIDTH + INPUT_PADDING, 5, INPUT_WIDTH, INPUT_HEIGHT};
+    Rectangle enterRect = {START_X + (INPUT_WIDTH + INPUT_PADDING) * 2, 5, INPUT_WIDTH, INPUT_HEIGHT};
+    Rectangle venueRect = {START_X + (INPUT_WIDTH + INPUT_PADDING) * 3, 5, INPUT_WIDTH, INPUT_HEIGHT};
+
+    static bool baseActive = false;
+    static bool quoteActive = false;
+
+    // Handle input focus
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        Vector2 mousePos = GetMousePosition();
+        baseActive = CheckCollisionPointRec(mousePos, baseRect);
+        quoteActive = CheckCollisionPointRec(mousePos, quoteRect);
+    }
+
+    // Draw input boxes
+    DrawRectangleRec(baseRect, baseActive ? INPUT_ACTIVE_BG : INPUT_BG);
+    DrawRectangleRec(quoteRect, quoteActive ? INPUT_ACTIVE_BG : INPUT_BG);
+
+    // Handle text input
+    if (baseActive) {
+        int key = GetCharPressed();
+        while (key > 0) {
+            if ((key >= 32) && (key <= 125) && (strlen(g_baseInput) < sizeof(g_baseInput) - 1)) {
+                g_baseInput[strlen(g_baseInput)] = (char)key;
+                g_baseInput[strlen(g_baseInput)] = '\0';
+            }
+            key = GetCharPressed();
+        }
+
+        if (IsKeyPressed(KEY_BACKSPACE) && strlen(g_baseInput) > 0) {
+            g_baseInput[strlen(g_baseInput) - 1] = '\0';
+        }
+    }
+
+    if (quoteActive) {
+        int key = GetCharPressed();
+        while (key > 0) {
+            if ((key >= 32) && (key <= 125) && (strlen(g_quoteInput) < sizeof(g_quoteInput) - 1)) {
+                g_quoteInput[strlen(g_quoteInput)] = (char)key;
+                g_quoteInput[strlen(g_quoteInput)] = '\0';
+            }
+            key = GetCharPressed();
+        }
+
+        if (IsKeyPressed(KEY_BACKSPACE) && strlen(g_quoteInput) > 0) {
+            g_quoteInput[strlen(g_quoteInput) - 1] = '\0';
+        }
+    }
+
+    // Draw input text
+    DrawTextEx(g_font, g_baseInput, {baseRect.x + 5, baseRect.y + 5}, 20, 1, WHITE);
+    DrawTextEx(g_font, g_quoteInput, {quoteRect.x + 5, quoteRect.y + 5}, 20, 1, WHITE);
+
+    // Draw and handle enter button
+    Vector2 mousePos = GetMousePosition();
+    bool isHovered = CheckCollisionPointRec(mousePos, enterRect);
+
+    DrawRectangleRec(enterRect, isHovered ? BUTTON_HOVER_COLOR : BUTTON_COLOR);
+    DrawTextEx(g_font, "Enter", {enterRect.x + 25, enterRect.y + 5}, 20, 1, WHITE);
+
+    if (isHovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        requestRefresh();
+    }
+
+    // Market switch; both books stay subscribed, so switching is instant
+    bool venueHovered = CheckCollisionPointRec(mousePos, venueRect);
+    DrawRectangleRec(venueRect, venueHovered ? BUTTON_HOVER_COLOR : BUTTON_COLOR);
+    const char* venueLabel = g_viewVenue == ViewVenue::Spot ? "Spot" : "Futures";
+    DrawTextEx(g_font, venueLabel, {venueRect.x + 12, venueRect.y + 5}, 20, 1, WHITE);
+
+    if ((venueHovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) || IsKeyPressed(KEY_TAB)) {
+        g_viewVenue = g_viewVenue == ViewVenue::Spot ? ViewVenue::Futures : ViewVenue::Spot;
+    }
+}
+
+// Add this function to draw market statistics
+void DrawMarketStats(const OrderBookMetrics& metrics, int topbarHeight) {
+    const int STATS_HEIGHT = 60;
+    const Color STATS_BG = {15, 15, 25, 255};
+    const int PADDING = 10;
+
+    // Draw stats background
+    DrawRectangle(0, topbarHeight, GetScreenWidth(), STATS_HEIGHT, STATS_BG);
+
+    // Format statistics (removed TWAP and VWAP)
+    char stats[2][64];
+    snprintf(stats[0], sizeof(stats[0]), "Spread: %.*f (%.2f%%)",
+             std::max(g_scale.priceDecimals, 0), metrics.spreadAmount, metrics.spreadPercentage);
+    snprintf(stats[1], sizeof(stats[1]), "B/A Ratio: %.2f%%",
+             metrics.liquidityImbalance * 100.0f);
+
+    // Draw statistics with improved layout
+    const int STAT_WIDTH = GetScreenWidth() / 2 + 2 ;  // Adjusted for fewer stats
+    for (int i = 0; i < 2; i++) {
+        Color textColor = WHITE;
+        if (i == 1) {  // Color imbalance based on value
+            textColor = metrics.liquidityImbalance > 0 ? GREEN : RED;
+        }
+
+        Vector2 pos = {
+            (float)(i * STAT_WIDTH + PADDING),
+            (float)(topbarHeight + (STATS_HEIGHT - 20) / 2)
+        };
+        DrawTextEx(g_font, stats[i], pos, 20, 1, textColor);
+    }
+}
+
+// Taker flow along the top of the stats: the window's net flow and CVD on the
+// left, net flow per second as bars around a centre line on the right
+void DrawOrderFlow(const OrderFlowMetrics& flow, int topbarHeight) {
+    const float LINE_TOP = topbarHeight + 3.0f;
+    const float LINE_HEIGHT = 14.0f;
+
+    // formatNumber shares one buffer, so each value is copied out before the next
+    char net[24], cvd[24], text[96];
+    snprintf(net, sizeof(net), "%c%s", flow.netFlow < 0 ? '-' : '+', formatNumber(std::fabs(flow.netFlow)));
+    snprintf(cvd, sizeof(cvd), "%c%s", flow.cumulativeDelta < 0 ? '-' : '+',
+             formatNumber(static_cast<float>(std::fabs(flow.cumulativeDelta))));
+    snprintf(text, sizeof(text), "Flow %zus: %s (%+.0f%%)  CVD: %s", OrderFlowMetrics::FLOW_HISTORY_SIZE, net,
+             flow.imbalanceRatio * 100.0f, cvd);
+    DrawTextEx(g_font, text, {10.0f, LINE_TOP}, LINE_HEIGHT, 1, flow.netFlow >= 0 ? GREEN : RED);
+
+    float x = GetScreenWidth() / 2.0f;
+    float width = GetScreenWidth() - x - 10;
+    float centre = LINE_TOP + LINE_HEIGHT / 2;
+    DrawLineEx({x, centre}, {x + width, centre}, 1, {60, 65, 80, 255});
+    if (flow.maxFlow <= 0) return;
+
+    float barWidth = width / OrderFlowMetrics::FLOW_HISTORY_SIZE;
+    for (size_t i = 0; i < OrderFlowMetrics::FLOW_HISTORY_SIZE; i++) {
+        float height = flow.flowHistory[i] / flow.maxFlow * (LINE_HEIGHT / 2);
+        if (height == 0) continue;
+        Rectangle bar = {x + i * barWidth, height > 0 ? centre - height : centre,
+                         std::max(barWidth - 1, 1.0f), std::fabs(height)};
+        DrawRectangleRec(bar, height > 0 ? GREEN : RED);
+    }
+}
+
+// Futures levels carry an order count, shown in a third column
+template <typename Venue>
+void DrawOrderbookRowsWithThresholds(
+    std::span<const typename Venue::Entry> orders,
+    Font& font, int startX, int width, int topbarHeight, int height,
+    const std::vector<Color>& colors, RowRenderCache& rowCache, bool isBid,
+    const OrderBookMetrics& metrics)
+{
+    if (orders.empty()) return;
+
+    const int ROW_HEIGHT = 18;  // Slightly reduced height
+    const int PRICE_WIDTH = Venue::HAS_ORDERS ? width * 0.4 : width * 0.55;    // 40% / 55%
+    const int VOLUME_WIDTH = Venue::HAS_ORDERS ? width * 0.3 : width * 0.45;   // 30% / 45%
+    const int TEXT_SIZE = 26;  // Slightly smaller text
+    const int TEXT_BLEED = std::max(0, (TEXT_SIZE - ROW_HEIGHT + 1) / 2);  // Text reaching past the row
+    const int PADDING = 8;
+
+    // Updated header style
+    const Color HEADER_BG = {25, 28, 36, 255};  // Darker, more professional header
+    DrawRectangle(startX, topbarHeight, width, ROW_HEIGHT, HEADER_BG);
+
+    // Add subtle gradient to header
+    Color gradientColor = {35, 38, 46, 100};
+    DrawRectangleGradientH(startX, topbarHeight, width, ROW_HEIGHT, HEADER_BG, gradientColor);
+
+    // Draw headers with improved positioning
+    Vector2 priceHeaderPos = {(float)startX + PADDING, (float)topbarHeight + (ROW_HEIGHT - TEXT_SIZE) / 2};
+    Vector2 volumeHeaderPos = {(float)startX + PRICE_WIDTH + PADDING, (float)topbarHeight + (ROW_HEIGHT - TEXT_SIZE) / 2};
+    Vector2 ordersHeaderPos = {(float)startX + PRICE_WIDTH + VOLUME_WIDTH + PADDING, (float)topbarHeight + (ROW_HEIGHT - TEXT_SIZE) / 2};
+    char priceHeader[48] = "Price";
+    if (g_shownGroupTicks) {
+        char step[32];
+        formatFixed(step, sizeof(step), g_shownGroupTicks, g_scale.priceDecimals, g_shownPriceDecimals);
+        snprintf(priceHeader, sizeof(priceHeader), "Price %s", step);
+    }
+    DrawTextEx(font, priceHeader, priceHeaderPos, TEXT_SIZE, 1, {180, 180, 180, 255});
+    DrawTextEx(font, "Amount", volumeHeaderPos, TEXT_SIZE, 1, {180, 180, 180, 255});
+    if constexpr (Venue::HAS_ORDERS) {
+        DrawTextEx(font, "Orders", ordersHeaderPos, TEXT_SIZE, 1, {180, 180, 180, 255});
+    }
+
+    // Draw separator line
+    DrawLine(startX + PRICE_WIDTH, topbarHeight,
+             startX + PRICE_WIDTH, topbarHeight + height,
+             {40, 40, 50, 255});
+
+    // Largest level for color scaling, kept up to date by the book engine
+    float maxVolume = isBid ? metrics.maxBidVolume : metrics.maxAskVolume;
+
+    // Draw rows with improved styling
+    for (size_t i = 0; i < orders.size(); i++) {
+        float volume = volumeOf(orders[i]);  // Use volume (amount) for color intensity
+        float y = topbarHeight + ((i + 1) * ROW_HEIGHT);
+
+        // Calculate color index based on volume/amount ratio
+        float volumeRatio = volume / (maxVolume * 1.2f);  // Adjusted scaling
+        int colorIndex = std::min(
+            static_cast<int>(volumeRatio * (colors.size() - 1)),
+            static_cast<int>(colors.size() - 1)
+        );
+
+        // The row is formatted and laid out again only when something on it changed
+        int32_t orderCount = 0;
+        if constexpr (Venue::HAS_ORDERS) orderCount = orders[i].orders;
+        RowRenderCache::Key key = {orders[i].price, orders[i].volume, orderCount, colorIndex,
+                                   width, ROW_HEIGHT, TEXT_BLEED, g_shownPriceDecimals, g_scale.qtyDecimals};
+        rowCache.draw(i, key, {(float)startX, y}, [&] {
+            // Draw row background with subtle gradient
+            Color baseColor = colors[colorIndex];
+            Color gradientEnd = {
+                (unsigned char)(baseColor.r * 0.9),
+                (unsigned char)(baseColor.g * 0.9),
+                (unsigned char)(baseColor.b * 0.9),
+                255
+            };
+            DrawRectangleGradientH(0, 0, width, ROW_HEIGHT, baseColor, gradientEnd);
+
+            // Format price and volume with improved number formatting
+            char priceStr[32], volumeStr[32], ordersStr[16];
+            formatFixed(priceStr, sizeof(priceStr), orders[i].price, g_scale.priceDecimals, g_shownPriceDecimals);
+            formatQuantity(volumeStr, sizeof(volumeStr), orders[i].volume, g_scale.qtyDecimals);
+
+            // Draw text with improved positioning and colors
+            Vector2 pricePos = {(float)PADDING, (float)((ROW_HEIGHT - TEXT_SIZE) / 2)};
+            Vector2 volumePos = {(float)(PRICE_WIDTH + PADDING), (float)((ROW_HEIGHT - TEXT_SIZE) / 2)};
+            Vector2 ordersPos = {(float)(PRICE_WIDTH + VOLUME_WIDTH + PADDING), (float)((ROW_HEIGHT - TEXT_SIZE) / 2)};
+
+            Color textColor = {230, 230, 230, 255};
+            DrawTextEx(font, priceStr, pricePos, TEXT_SIZE, 1, textColor);
+            DrawTextEx(font, volumeStr, volumePos, TEXT_SIZE, 1, textColor);
+            if constexpr (Venue::HAS_ORDERS) {
+                snprintf(ordersStr, sizeof(ordersStr), "%d", orderCount);
+                DrawTextEx(font, ordersStr, ordersPos, TEXT_SIZE, 1, textColor);
+            }
+        });
+    }
+
+    // Add subtle separator between price and volume columns
+    DrawLine(startX + PRICE_WIDTH, topbarHeight,
+             startX + PRICE_WIDTH, topbarHeight + height,
+             {45, 48, 56, 255});  // Darker separator color
+}
+
+// Fills `batch` with a depth curve and its glow: the outer and inner glow
+// layers first, then the main line on top
+void BuildDepthCurve(LineBatch& batch, std::span<const int64_t> curve, float maxDepthTicks,
+                     int x, int y, int width, int height, Color color) {
+    batch.clear();
+    if (curve.size() < 2 || maxDepthTicks <= 0) return;
+
+    auto pointAt = [&](size_t i) -> Vector2 {
+        return {
+            static_cast<float>(x + i * width / curve.size()),
+            static_cast<float>(y + height - (curve[i] / maxDepthTicks) * height)
+        };
+    };
+
+    const float THICKNESS[] = {4, 2, 1};
+    const unsigned char ALPHA[] = {20, 40, 255};
+    for (int layer = 0; layer < 3; layer++) {
+        Color layerColor = {color.r, color.g, color.b, ALPHA[layer]};
+        for (size_t i = 1; i < curve.size(); i++) {
+            batch.addLine(pointAt(i - 1), pointAt(i), THICKNESS[layer], layerColor);
+        }
+    }
+}
+
+// Add this function to draw the market depth curve
+void DrawMarketDepthCurve(const MarketDepthMetrics& metrics, int x, int y, int width, int height) {
+    const Color BID_COLOR = {0, 150, 255, 255};      // Brighter blue
+    const Color ASK_COLOR = {255, 95, 95, 255};      // Brighter red
+    const Color GRID_COLOR = {40, 45, 60, 100};      // Matching grid color
+    const Color AXIS_COLOR = {80, 85, 100, 255};     // Brighter axes
+
+    // Grid and axes are built into one vertex batch and curves into one per
+    // side; they are rebuilt only when the chart moves or the depth changes
+    const int GRID_LINES = 6;
+    Rectangle area = {(float)x, (float)y, (float)width, (float)height};
+    auto sameArea = [](const Rectangle& a, const Rectangle& b) {
+        return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+    };
+
+    static LineBatch gridBatch;
+    static Rectangle gridArea = {};
+    if (gridBatch.empty() || !sameArea(area, gridArea)) {
+        gridArea = area;
+        gridBatch.clear();
+        for (int i = 1; i < GRID_LINES; i++) {
+            float yPos = y + (height * i) / GRID_LINES;
+            float xPos = x + (width * i) / GRID_LINES;
+            gridBatch.addLine({(float)x, yPos}, {(float)(x + width), yPos}, 1, GRID_COLOR);
+            gridBatch.addLine({xPos, (float)y}, {xPos, (float)(y + height)}, 1, GRID_COLOR);
+        }
+
+        // Axes with subtle glow
+        gridBatch.addLine({(float)x, (float)(y + height)}, {(float)(x + width), (float)(y + height)}, 3, {80, 85, 100, 30});
+        gridBatch.addLine({(float)x, (float)y}, {(float)x, (float)(y + height)}, 3, {80, 85, 100, 30});
+        gridBatch.addLine({(float)x, (float)(y + height)}, {(float)(x + width), (float)(y + height)}, 2, AXIS_COLOR);
+        gridBatch.addLine({(float)x, (float)y}, {(float)x, (float)(y + height)}, 2, AXIS_COLOR);
+    }
+    gridBatch.draw();
+
+    float maxDepth = std::max(metrics.cumulativeBidVolume, metrics.cumulativeAskVolume);
+    float maxDepthTicks = static_cast<float>(metrics.maxDepthTicks);
+
+    static LineBatch bidBatch;
+    static LineBatch askBatch;
+    static std::vector<int64_t> bidBuilt;
+    static std::vector<int64_t> askBuilt;
+    static Rectangle curveArea = {};
+    if (!sameArea(area, curveArea) ||
+        !std::equal(metrics.bidDepthCurve.begin(), metrics.bidDepthCurve.end(), bidBuilt.begin(), bidBuilt.end()) ||
+        !std::equal(metrics.askDepthCurve.begin(), metrics.askDepthCurve.end(), askBuilt.begin(), askBuilt.end())) {
+        curveArea = area;
+        bidBuilt.assign(metrics.bidDepthCurve.begin(), metrics.bidDepthCurve.end());
+        askBuilt.assign(metrics.askDepthCurve.begin(), metrics.askDepthCurve.end());
+        BuildDepthCurve(bidBatch, metrics.bidDepthCurve, maxDepthTicks, x, y, width, height, BID_COLOR);
+        BuildDepthCurve(askBatch, metrics.askDepthCurve, maxDepthTicks, x, y, width, height, ASK_COLOR);
+    }
+    bidBatch.draw();
+    askBatch.draw();
+
+    // Draw volume labels with improved styling
+    char volumeLabel[32];
+    for (int i = 0; i <= GRID_LINES; i++) {
+        float volume = (maxDepth * (GRID_LINES - i)) / GRID_LINES;
+
+        // Format volume with K/M suffixes
+        if (volume >= 1000000) {
+            snprintf(volumeLabel, sizeof(volumeLabel), "%.1fM", volume / 1000000);
+        } else if (volume >= 1000) {
+            snprintf(volumeLabel, sizeof(volumeLabel), "%.1fK", volume / 1000);
+        } else {
+            snprintf(volumeLabel, sizeof(volumeLabel), "%.1f", volume);
+        }
+
+        // Draw label text with shadow
+        Vector2 textPos = {(float)x - 65, (float)(y + (height * i) / GRID_LINES - 10)};
+        DrawTextEx(g_font, volumeLabel, {textPos.x + 1, textPos.y + 1}, 16, 1, {0, 0, 0, 128});
+        DrawTextEx(g_font, volumeLabel, textPos, 16, 1, {220, 220, 220, 255});
+    }
+}
+
+// Font of the order book rows, loaded on first use
+Font& RowFont() {
+    static Font customFont = {};
+    static bool fontLoaded = false;
+    if (!fontLoaded) {
+        customFont = LoadFont("../resources/Kanit/Kanit-Regular.ttf");
+        SetTextureFilter(customFont.texture, TEXTURE_FILTER_BILINEAR);
+        fontLoaded = true;
+    }
+    return customFont;
+}
+
+// Stage percentiles in the lower right corner, refreshed a few times a second
+void DrawLatencyOverlay(const LatencyStats& latency) {
+    static constexpr double PERCENTILES[] = {50, 99, 99.9};
+    static constexpr const char* HEADER[] = {"stage", "p50", "p99", "p99.9", "max"};
+    static char cells[LatencyStats::STAGES][5][24];
+    static double lastRefresh = -1;
+
+    if (GetTime() - lastRefresh >= 0.25) {
+        lastRefresh = GetTime();
+        for (size_t i = 0; i < LatencyStats::STAGES; i++) {
+            auto stage = static_cast<LatencyStage>(i);
+            const LatencyHistogram& histogram = latency[stage];
+            int64_t values[3];
+            histogram.percentiles(PERCENTILES, values, 3);
+
+            snprintf(cells[i][0], sizeof(cells[i][0]), "%s", LatencyStats::stageName(stage));
+            for (int v = 0; v < 3; v++) formatLatency(cells[i][v + 1], sizeof(cells[i][v + 1]), values[v]);
+            formatLatency(cells[i][4], sizeof(cells[i][4]), histogram.max());
+        }
+    }
+
+    const int LINE_HEIGHT = 16;
+    const int COLUMN_WIDTH = 64;
+    const int width = COLUMN_WIDTH * 5 + 12;
+    const int height = LINE_HEIGHT * (LatencyStats::STAGES + 1) + 8;
+    const int x = GetScreenWidth() - width - 8;
+    const int y = GetScreenHeight() - height - 8;
+    DrawRectangle(x, y, width, height, {0, 0, 0, 200});
+
+    for (int column = 0; column < 5; column++) {
+        Vector2 position = {(float)(x + 6 + column * COLUMN_WIDTH), (float)(y + 4)};
+        DrawTextEx(g_font, HEADER[column], position, 14, 1, GRAY);
+        for (size_t i = 0; i < LatencyStats::STAGES; i++) {
+            position.y += LINE_HEIGHT;
+            DrawTextEx(g_font, cells[i][column], position, 14, 1, {220, 220, 220, 255});
+        }
+    }
+}
+
+// Mid of a symbol's latest published book, 0 while a side is empty
+template <typename Venue>
+double publishedMid(const typename VenueFeed<Venue>::Symbol* feed) {
+    if (!feed) return 0;
+    typename VenueFeed<Venue>::BookView view;
+    feed->snapshot.read(view);
+    if (!view.bidCount || !view.askCount) return 0;
+    return fixedToDouble(view.bids[0].price + view.asks[0].price, view.scale.priceDecimals) / 2;
+}
+
+// The rows of both sides below the depth chart, with the volume overlay
+template <typename Venue>
+void DrawVenueRows(std::span<const typename Venue::Entry> bids, std::span<const typename Venue::Entry> asks,
+                   const OrderBookMetrics& metrics, int rowsTop, int overlayTop, int columnWidth) {
+    Font& customFont = RowFont();
+
+    // Update the color constants to use pure blue/red gradients
+    const std::vector<Color> bidColors = {
+        {0, 0, 50, 255},     // Darkest blue
+        {0, 0, 90, 255},
+        {0, 0, 130, 255},
+        {0, 0, 170, 255},
+        {0, 0, 210, 255},
+        {0, 0, 255, 255}     // Brightest blue
+    };
+
+    const std::vector<Color> askColors = {
+        {50, 0, 0, 255},     // Darkest red
+        {90, 0, 0, 255},
+        {130, 0, 0, 255},
+        {170, 0, 0, 255},
+        {210, 0, 0, 255},
+        {255, 0, 0, 255}     // Brightest red
+    };
+
+    // Rendered rows, reused until their level changes
+    static RowRenderCache bidRows(VenueFeed<Venue>::BOOK_DEPTH);
+    static RowRenderCache askRows(VenueFeed<Venue>::BOOK_DEPTH);
+
+    // Adjust orderbook position
+    DrawRectangle(0, rowsTop, GetScreenWidth(),
+                 GetScreenHeight() - rowsTop, BLACK);
+
+    // Update orderbook drawing calls with new vertical offset
+    DrawOrderbookRowsWithThresholds<Venue>(
+        bids, customFont, 0, columnWidth, rowsTop,
+        GetScreenHeight() - rowsTop, bidColors, bidRows, true, metrics
+    );
+
+    DrawOrderbookRowsWithThresholds<Venue>(
+        asks, customFont, columnWidth, columnWidth, rowsTop,
+        GetScreenHeight() - rowsTop, askColors, askRows, false, metrics
+    );
+
+    // Draw heatmap overlays with adjusted position
+    DrawOrderBookHeatmap(bids, 0, columnWidth, overlayTop, metrics, true);
+    DrawOrderBookHeatmap(asks, columnWidth, columnWidth, overlayTop, metrics, false);
+}
+
+// Draws the book of one market. Each instantiation keeps its own snapshot
+// copy and row caches, so switching markets redraws nothing needlessly.
+template <typename Venue>
+void DrawVenueBook(const typename VenueFeed<Venue>::Symbol* feed, LatencyStats& latency, LiquidityHeatmap& heatmap,
+                   double spotMid, double futuresMid) {
+    using Entry = typename Venue::Entry;
+
+    // Copy out the latest book of the selected symbol; never blocks its worker
+    static typename VenueFeed<Venue>::BookView view;
+    static uint64_t drawnVersion = 0;
+    if (feed) feed->snapshot.read(view);
+    if (view.version != drawnVersion) {
+        drawnVersion = view.version;
+        if (view.recvNs) {
+            g_presentPendingNs = view.recvNs;
+            g_presentLatency = &latency;
+        }
+    }
+    g_scale = view.scale;
+    std::span<const Entry> bids = view.bidLevels();
+    std::span<const Entry> asks = view.askLevels();
+
+    // Bucketed rows once the worker has published the selected grouping;
+    // until then, and without one, the raw levels
+    static typename VenueFeed<Venue>::GroupedView grouped;
+    if (feed && g_grouping) feed->groupedSnapshot.read(grouped);
+    bool showGrouped = feed && g_grouping && grouped.grouping == g_grouping && grouped.groupTicks &&
+                       grouped.scale.priceDecimals == view.scale.priceDecimals;
+    g_shownGroupTicks = showGrouped ? grouped.groupTicks : 0;
+    g_shownPriceDecimals = shownPriceDecimals(view.scale.priceDecimals, g_shownGroupTicks);
+
+    // Constants for layout
+    const int TOPBAR_HEIGHT = 40;
+    const int STATS_HEIGHT = 60;
+    const int CONTENT_START = TOPBAR_HEIGHT + STATS_HEIGHT;
+    const int COLUMN_WIDTH = GetScreenWidth() / 2;
+
+    // Calculate metrics first; the trend comes with the snapshot
+    OrderBookMetrics metrics = calculateOrderBookMetrics(view);
+    MarketDepthMetrics depthMetrics = calculateMarketDepth(view);
+    OrderFlow flow = {};
+    if (feed) feed->flowSnapshot.read(flow);
+    OrderFlowMetrics flowMetrics = calculateOrderFlow(flow);
+
+    // Now start drawing, beginning with the topbar
+    RL_MEXC_Orderbook_Topbar();
+
+    // Draw market statistics below topbar
+    DrawMarketStats(metrics, TOPBAR_HEIGHT);
+    DrawOrderFlow(flowMetrics, TOPBAR_HEIGHT);
+
+    // Snapshot hand-off counters; the writer is wait-free so only readers retry
+    char publishStats[64];
+    snprintf(publishStats, sizeof(publishStats), "Writes: %llu  Reader retries: %llu",
+             static_cast<unsigned long long>(feed ? feed->snapshot.writes() : 0),
+             static_cast<unsigned long long>(feed ? feed->snapshot.readerRetries() : 0));
+    DrawTextEx(g_font, publishStats, {10.0f, (float)(TOPBAR_HEIGHT + STATS_HEIGHT - 16)}, 14, 1, GRAY);
+
+    // Futures against spot for the same pair, once both books are live
+    if (spotMid > 0 && futuresMid > 0) {
+        double basis = futuresMid - spotMid;
+        char basisText[64];
+        snprintf(basisText, sizeof(basisText), "Basis: %+.*f (%+.3f%%)", std::max(g_scale.priceDecimals, 0), basis,
+                 basis / spotMid * 100.0);
+        Vector2 size = MeasureTextEx(g_font, basisText, 14, 1);
+        DrawTextEx(g_font, basisText, {GetScreenWidth() - size.x - 10, (float)(TOPBAR_HEIGHT + STATS_HEIGHT - 16)},
+                   14, 1, basis >= 0 ? GREEN : RED);
+    }
+
+    // Layout adjustments with proper spacing
+    const int DEPTH_CHART_HEIGHT = 150;
+    const int ORDERBOOK_START = CONTENT_START + DEPTH_CHART_HEIGHT;
+
+    // Draw market depth curve below stats
+    DrawMarketDepthCurve(depthMetrics, 0, CONTENT_START,
+                        GetScreenWidth(), DEPTH_CHART_HEIGHT);
+
+    if (IsKeyPressed(KEY_F4)) g_showHeatmap = !g_showHeatmap;
+    if (g_showHeatmap) {
+        Rectangle area = {0, (float)ORDERBOOK_START, (float)GetScreenWidth(),
+                          (float)(GetScreenHeight() - ORDERBOOK_START)};
+        heatmap.handleZoom(area);
+        heatmap.draw(area, g_font);
+    } else if (showGrouped) {
+        // Buckets are scaled against each other, not against single levels
+        OrderBookMetrics groupedMetrics = metrics;
+        groupedMetrics.maxBidVolume = static_cast<float>(fixedToDouble(grouped.bidMaxVolume, view.scale.qtyDecimals));
+        groupedMetrics.maxAskVolume = static_cast<float>(fixedToDouble(grouped.askMaxVolume, view.scale.qtyDecimals));
+        DrawVenueRows<Venue>(grouped.bidLevels(), grouped.askLevels(), groupedMetrics, ORDERBOOK_START,
+                             CONTENT_START, COLUMN_WIDTH);
+    } else {
+        DrawVenueRows<Venue>(bids, asks, metrics, ORDERBOOK_START, CONTENT_START, COLUMN_WIDTH);
+    }
+
+    if (IsKeyPressed(KEY_F3)) g_showLatency = !g_showLatency;
+    if (g_showLatency) DrawLatencyOverlay(latency);
+}
+
+// Book, flow, grouped and ladder publishes of a symbol so far; any one is worth a redraw
+template <typename Symbol>
+uint64_t publishesOf(const Symbol* feed) {
+    return feed ? feed->snapshot.writes() + feed->flowSnapshot.writes() + feed->groupedSnapshot.writes() +
+                  feed->ladderSnapshot.writes()
+                : 0;
+}
+
+// The grouping after `grouping` whose step is a whole number of the shown
+// pair's price ticks, past the last one back to the raw levels
+template <typename Feed>
+uint32_t NextGrouping(const Feed& venueFeed, uint32_t grouping) {
+    const std::vector<std::string>& steps = venueFeed.groupingSteps();
+    for (uint32_t next = grouping + 1; next <= steps.size(); next++) {
+        if (Feed::stepTicks(steps[next - 1], g_scale)) return next;
+    }
+    return 0;
+}
+
+// Points the shown pair's worker at the selected grouping; posts only on a change
+template <typename Feed>
+void SelectGrouping(Feed& venueFeed, typename Feed::Symbol* feed) {
+    if (feed && feed->grouping.load(std::memory_order_relaxed) != g_grouping) venueFeed.setGrouping(*feed, g_grouping);
+}
+
+// Adds a market's latest ladder to its heatmap; a new symbol starts a new
+// history, and only the sampled symbol's worker publishes its ladder
+template <typename Feed>
+void SampleHeatmap(LiquidityHeatmap& heatmap, Feed& venueFeed, typename Feed::Symbol* feed) {
+    static_assert(Feed::LADDER_ROWS >= 2 * LiquidityHeatmap::ROWS, "The heatmap's rows must lie inside the ladder");
+    static typename Feed::Symbol* sampled = nullptr;
+    static typename Feed::LadderView ladder;
+    if (feed != sampled) {
+        if (sampled) venueFeed.setLadder(*sampled, false);
+        if (feed) venueFeed.setLadder(*feed, true);
+        sampled = feed;
+        heatmap.reset();
+    }
+    if (!feed) return;
+    feed->ladderSnapshot.read(ladder);
+    heatmap.add(GetTime(), ladder);
+}
+
+void RL_MEXC_Orderbook() {
+    SpotFeed::Symbol* spot = g_spotView.load(std::memory_order_acquire);
+    FuturesFeed::Symbol* futures = g_futuresView.load(std::memory_order_acquire);
+
+    // Both markets follow the grouping, so switching venue shows it at once
+    if (IsKeyPressed(KEY_F5)) {
+        g_grouping = g_viewVenue == ViewVenue::Spot ? NextGrouping(g_spotFeed, g_grouping)
+                                                    : NextGrouping(g_futuresFeed, g_grouping);
+    }
+    SelectGrouping(g_spotFeed, spot);
+    SelectGrouping(g_futuresFeed, futures);
+
+    // Taken first: a publish during the reads below still counts as new
+    g_drawnVenue = g_viewVenue;
+    g_drawnSpot = spot;
+    g_drawnFutures = futures;
+    g_drawnSpotWrites = publishesOf(spot);
+    g_drawnFuturesWrites = publishesOf(futures);
+
+    SampleHeatmap(g_spotHeatmap, g_spotFeed, spot);
+    SampleHeatmap(g_futuresHeatmap, g_futuresFeed, futures);
+
+    double spotMid = publishedMid<SpotVenue>(spot);
+    double futuresMid = publishedMid<FuturesVenue>(futures);
+    if (g_viewVenue == ViewVenue::Spot) {
+        DrawVenueBook<SpotVenue>(spot, g_spotFeed.latency(), g_spotHeatmap, spotMid, futuresMid);
+    } else {
+        DrawVenueBook<FuturesVenue>(futures, g_futuresFeed.latency(), g_futuresHeatmap, spotMid, futuresMid);
+    }
+}
+
+
+bool RL_MEXC_Orderbook_Changed() {
+    if (g_viewVenue != g_drawnVenue) return true;
+    SpotFeed::Symbol* spot = g_spotView.load(std::memory_order_acquire);
+    FuturesFeed::Symbol* futures = g_futuresView.load(std::memory_order_acquire);
+    if (spot != g_drawnSpot || futures != g_drawnFutures) return true;
+    return publishesOf(spot) != g_drawnSpotWrites || publishesOf(futures) != g_drawnFuturesWrites;
+}
+
+void RL_MEXC_Orderbook_Presented() {
+    if (g_presentPendingNs && g_presentLatency) {
+        g_presentLatency->record(LatencyStage::Present, steadyNowNs() - g_presentPendingNs);
+        g_presentPendingNs = 0;
+    }
+}
+
+// Shows the pair in the inputs on both markets, subscribing it first where it
+// is new. Other symbols and their connections are left alone.
+void requestRefresh() {
+    g_shouldRefresh = true;
+    g_spotFeed.add(g_baseInput, g_quoteInput, [](uint32_t index) {
+        g_spotView = g_spotFeed.symbol(index);
+        g_shouldRefresh = false;
+    });
+    g_futuresFeed.add(g_baseInput, g_quoteInput, [](uint32_t index) {
+        g_futuresView = g_futuresFeed.symbol(index);
+        g_shouldRefresh = false;
+    });
+}
+
+void MEXC_Connection() {
+    try {
+        MEXC_Feed_Start();
+        requestRefresh();
+
+        // Serves every connection, its timers and reconnects
+        g_ioc.run();
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+    }
+}
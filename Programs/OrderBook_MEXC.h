@@ -0,0 +1,17 @@
+#ifndef ORDERBOOK_MEXC_H
+#define ORDERBOOK_MEXC_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <raylib.h>
+
+extern Font g_font;  // Declare global font
+void RL_MEXC_Orderbook_Topbar();
+void RL_MEXC_Orderbook();
+void RL_MEXC_Orderbook_Presented();  // Call after EndDrawing()
+bool RL_MEXC_Orderbook_Changed();    // Something to draw since the last RL_MEXC_Orderbook()
+void MEXC_Connection();
+
+
+#endif //ORDERBOOK_MEXC_H
@@ -1,15 +0,0 @@
-#ifndef ORDERBOOK_MEXC_SPOT_H
-#define ORDERBOOK_MEXC_SPOT_H
-
-#include <string>
-#include <vector>
-#include <thread>
-#include <raylib.h>
-
-extern Font g_font;  // Declare global font
-void RL_MEXC_Orderbook_Spot_Topbar();
-void RL_MEXC_Orderbook_Spot();
-void MEXC_Connection();
-
-
-#endif //ORDERBOOK_MEXC_SPOT_H
\ No newline at end of file
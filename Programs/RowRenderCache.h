@@ -0,0 +1,118 @@
+//
+// Order book rows rendered once into textures and redrawn as one quad.
+//
+// Formatting a level and laying out its glyphs costs far more than drawing a
+// texture, and most rows look the same from one frame to the next. Each row
+// slot keeps a render texture plus the key it was drawn from; the row is
+// rendered again only when its key changes (price, volume, orders, color band,
+// size or decimals).
+//
+// Text may be taller than its row and spill `bleed` pixels above and below
+// it, as it does when drawn straight to the screen. The texture includes that
+// margin, transparent outside the row, and is composited premultiplied, so a
+// cached row looks exactly like one drawn directly.
+//
+// Textures belong to the GL context and are not released by the destructor:
+// call unload() before CloseWindow(), or let them go with the context.
+//
+
+#ifndef ROW_RENDER_CACHE_H
+#define ROW_RENDER_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <raylib.h>
+#include <rlgl.h>
+
+class RowRenderCache {
+public:
+    struct Key {
+        int64_t price = 0;
+        int64_t volume = 0;
+        int32_t orders = 0;
+        int colorIndex = -1;
+        int width = 0;
+        int height = 0;
+        int bleed = 0;          // Pixels the row's text may reach above and below it
+        int priceDecimals = -1;
+        int qtyDecimals = -1;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    explicit RowRenderCache(size_t rows) : m_rows(rows) {}
+
+    // Draws row `index` with its top left corner at `position`. `render` draws
+    // the row at (0, 0), text possibly reaching key.bleed pixels outside it,
+    // and runs only when the key differs from last time.
+    template <typename Render>
+    void draw(size_t index, const Key& key, Vector2 position, Render&& render) {
+        if (index >= m_rows.size()) m_rows.resize(index + 1);
+        Row& row = m_rows[index];
+
+        if (!row.valid || row.stale || !(row.key == key)) {
+            if (row.valid && (row.key.width != key.width || row.key.height != key.height ||
+                              row.key.bleed != key.bleed)) {
+                UnloadRenderTexture(row.texture);
+                row.valid = false;
+            }
+            if (!row.valid) row.texture = LoadRenderTexture(key.width, key.height + 2 * key.bleed);
+
+            // Colors go in premultiplied with their real coverage as alpha,
+            // so glyph edges in the transparent margin blend like on screen
+            BeginTextureMode(row.texture);
+            ClearBackground(BLANK);
+            rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                                      RL_FUNC_ADD, RL_FUNC_ADD);
+            BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+            BeginMode2D(Camera2D{{0, (float)key.bleed}, {0, 0}, 0, 1});
+            render();
+            EndMode2D();
+            EndBlendMode();
+            EndTextureMode();
+
+            row.key = key;
+            row.valid = true;
+            row.stale = false;
+            m_renders++;
+        } else {
+            m_hits++;
+        }
+
+        // Render textures are stored bottom up
+        Rectangle source = {0, 0, (float)key.width, -(float)(key.height + 2 * key.bleed)};
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(row.texture.texture, source, {position.x, position.y - key.bleed}, WHITE);
+        EndBlendMode();
+    }
+
+    // Forces every row to be rendered again, e.g. after the font changed
+    void invalidate() {
+        for (Row& row : m_rows) row.stale = true;
+    }
+
+    void unload() {
+        for (Row& row : m_rows) {
+            if (row.valid) UnloadRenderTexture(row.texture);
+            row.valid = false;
+        }
+    }
+
+    uint64_t renders() const { return m_renders; }
+    uint64_t hits() const { return m_hits; }
+
+private:
+    struct Row {
+        RenderTexture2D texture = {};
+        Key key;
+        bool valid = false;     // Texture is loaded
+        bool stale = false;     // Render again even if the key matches
+    };
+
+    std::vector<Row> m_rows;
+    uint64_t m_renders = 0;
+    uint64_t m_hits = 0;
+};
+
+#endif //ROW_RENDER_CACHE_H
@@ -0,0 +1,154 @@
+#include "ShardPool.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SHARD_SPIN_PAUSE() _mm_pause()
+#else
+#define SHARD_SPIN_PAUSE() ((void)0)
+#endif
+
+size_t ShardPool::defaultShardCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 3 ? cores - 2 : 1;
+}
+
+ShardPool::ShardPool(size_t shardCount, Handler handler, size_t queueCapacity)
+    : m_handler(std::move(handler)) {
+    size_t capacity = std::bit_ceil(std::max<size_t>(queueCapacity, 2));
+    for (size_t i = 0; i < std::max<size_t>(shardCount, 1); i++) {
+        auto shard = std::make_unique<Shard>();
+        shard->slots.resize(capacity);
+        shard->mask = capacity - 1;
+        m_shards.push_back(std::move(shard));
+    }
+}
+
+ShardPool::~ShardPool() {
+    stop();
+}
+
+void ShardPool::start(bool pinThreads, size_t firstCore) {
+    if (m_running.exchange(true)) return;
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        Shard& shard = *m_shards[i];
+        shard.worker = std::thread([this, &shard] { run(shard); });
+
+#if defined(__linux__)
+        if (pinThreads) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET((firstCore + i) % cores, &set);
+            if (pthread_setaffinity_np(shard.worker.native_handle(), sizeof(set), &set) != 0) {
+                std::cerr << "Could not pin shard " << i << " to core " << (firstCore + i) % cores << std::endl;
+            }
+        }
+#else
+        (void)pinThreads;
+        (void)firstCore;
+        (void)cores;
+#endif
+    }
+}
+
+void ShardPool::stop() {
+    if (!m_running.exchange(false)) return;
+
+    for (auto& shard : m_shards) {
+        // Wake a worker blocked on an empty queue
+        shard->wake.fetch_add(1);
+        shard->wake.notify_one();
+    }
+    for (auto& shard : m_shards) {
+        if (shard->worker.joinable()) shard->worker.join();
+    }
+}
+
+bool ShardPool::post(uint32_t symbol, Kind kind, std::string_view text, int64_t recvNs) {
+    Shard& shard = *m_shards[shardOf(symbol)];
+    uint64_t tail = shard.tail.load(std::memory_order_relaxed);
+
+    if (tail - shard.cachedHead > shard.mask) {
+        shard.cachedHead = shard.head.load(std::memory_order_acquire);
+        while (tail - shard.cachedHead > shard.mask) {
+            if (kind == Kind::Message) {
+                shard.dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+            shard.cachedHead = shard.head.load(std::memory_order_acquire);
+        }
+    }
+
+    Slot& slot = shard.slots[tail & shard.mask];
+    slot.symbol = symbol;
+    slot.kind = kind;
+    slot.recvNs = recvNs;
+    slot.text.assign(text.data(), text.size());
+
+    // Paired with the worker's sleeping store / tail load: either it sees the
+    // new tail or we see it asleep
+    shard.tail.store(tail + 1, std::memory_order_seq_cst);
+    if (shard.sleeping.load(std::memory_order_seq_cst)) {
+        shard.wake.fetch_add(1);
+        shard.wake.notify_one();
+    }
+    return true;
+}
+
+uint64_t ShardPool::droppedCount() const {
+    uint64_t total = 0;
+    for (const auto& shard : m_shards) {
+        total += shard->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void ShardPool::run(Shard& shard) {
+    uint64_t head = shard.head.load(std::memory_order_relaxed);
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        uint64_t tail = shard.tail.load(std::memory_order_acquire);
+
+        if (head == tail) {
+            // Spin briefly before sleeping; bursts usually arrive back to back
+            for (int spin = 0; spin < 256 && tail == head; spin++) {
+                SHARD_SPIN_PAUSE();
+                tail = shard.tail.load(std::memory_order_acquire);
+            }
+            if (tail == head) {
+                uint32_t wake = shard.wake.load();
+                shard.sleeping.store(true, std::memory_order_seq_cst);
+                if (shard.tail.load(std::memory_order_seq_cst) == head &&
+                    m_running.load(std::memory_order_relaxed)) {
+                    shard.wake.wait(wake);
+                }
+                shard.sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+        }
+
+        for (; head != tail; head++) {
+            Slot& slot = shard.slots[head & shard.mask];
+            try {
+                m_handler(slot.symbol, slot.kind, slot.text, slot.recvNs);
+            } catch (const std::exception& e) {
+                std::cerr << "Shard handler error: " << e.what() << std::endl;
+            }
+            // A REST snapshot (a few hundred KB for 5000 spot levels) would
+            // otherwise stay allocated in its slot for good
+            if (slot.kind == Kind::Snapshot) std::string().swap(slot.text);
+            shard.head.store(head + 1, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+//
+// Worker threads that own the per-symbol books.
+//
+// Symbols are spread over the shards by index, so every book is only ever
+// touched by one worker and needs no locking. The connection thread copies
+// each raw frame into the owning shard's queue, a fixed ring of reusable
+// string slots with one producer and one consumer. Workers are pinned to
+// their own core where the platform allows it.
+//
+
+#ifndef SHARD_POOL_H
+#define SHARD_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class ShardPool {
+public:
+    enum class Kind : uint8_t {
+        Message,    // A raw frame for the symbol
+        Reset,      // The symbol's stream (re)started: drop its book
+        Refresh,    // Republish the symbol's snapshots, e.g. for another view of the book
+        Snapshot    // A depth snapshot fetched for the symbol; empty if the fetch failed
+    };
+
+    // Runs on the shard's worker thread; text is only valid during the call.
+    // recvNs is the producer's steadyNowNs() stamp for the frame, 0 if none.
+    using Handler = std::function<void(uint32_t symbol, Kind kind, std::string_view text, int64_t recvNs)>;
+
+    // Default number of shards: what is left after the render and connection threads
+    static size_t defaultShardCount();
+
+    ShardPool(size_t shardCount, Handler handler, size_t queueCapacity = 4096);
+    ~ShardPool();
+
+    ShardPool(const ShardPool&) = delete;
+    ShardPool& operator=(const ShardPool&) = delete;
+
+    // Starts the workers, pinning worker i to core firstCore + i
+    void start(bool pinThreads = true, size_t firstCore = 2);
+    void stop();
+
+    size_t shardCount() const { return m_shards.size(); }
+    size_t shardOf(uint32_t symbol) const { return symbol % m_shards.size(); }
+
+    // Producer side; only one thread may post. A message that does not fit
+    // is dropped and counted (the symbol's version check then forces a
+    // resync); the other kinds always wait for room.
+    bool post(uint32_t symbol, Kind kind, std::string_view text = {}, int64_t recvNs = 0);
+
+    uint64_t droppedCount() const;
+
+private:
+    struct Slot {
+        uint32_t symbol = 0;
+        Kind kind = Kind::Message;
+        int64_t recvNs = 0;
+        std::string text;   // Capacity is kept between uses, except after a Snapshot
+    };
+
+    struct Shard {
+        std::vector<Slot> slots;
+        size_t mask = 0;
+        alignas(64) std::atomic<uint64_t> head{0};  // Next slot to read, advanced by the worker
+        alignas(64) std::atomic<uint64_t> tail{0};  // Next slot to write, advanced by the producer
+        uint64_t cachedHead = 0;                    // Producer's last view of head
+        std::atomic<bool> sleeping{false};          // Worker is about to block on wake
+        std::atomic<uint32_t> wake{0};
+        std::atomic<uint64_t> dropped{0};
+        std::thread worker;
+    };
+
+    void run(Shard& shard);
+
+    Handler m_handler;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::atomic<bool> m_running{false};
+};
+
+#endif //SHARD_POOL_H
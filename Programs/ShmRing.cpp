@@ -0,0 +1,238 @@
+#include "ShmRing.h"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr uint32_t SHM_VERSION = 1;
+constexpr size_t SHM_WORDS = sizeof(BookRecord) / sizeof(uint64_t);
+
+static size_t alignLine(size_t bytes) {
+    return (bytes + SHM_CACHE_LINE - 1) & ~(SHM_CACHE_LINE - 1);
+}
+
+static size_t symbolTableBytes(size_t symbols) {
+    return alignLine(symbols * sizeof(BookSymbolName));
+}
+
+static size_t ringBytes(size_t slots) {
+    return sizeof(ShmRingHeader) + slots * sizeof(ShmSlot);
+}
+
+static ShmSlot* slotsOf(ShmRingHeader* ring) {
+    return reinterpret_cast<ShmSlot*>(ring + 1);
+}
+
+static const ShmSlot* slotsOf(const ShmRingHeader* ring) {
+    return reinterpret_cast<const ShmSlot*>(ring + 1);
+}
+
+ShmFeedWriter::ShmFeedWriter(std::string name, std::string_view venue, size_t rings, size_t slotsPerRing,
+                             size_t symbolCapacity)
+    : m_name(std::move(name)),
+      m_venue(venue),
+      m_ringCount(std::max<size_t>(rings, 1)),
+      m_slots(std::bit_ceil(std::max<size_t>(slotsPerRing, 64))),
+      m_symbolCapacity(std::max<size_t>(symbolCapacity, 1)) {}
+
+ShmFeedWriter::~ShmFeedWriter() {
+    if (!m_base) return;
+    munmap(m_base, m_size);
+    // Readers keep their mapping; new ones find nothing until the next run
+    shm_unlink(m_name.c_str());
+}
+
+bool ShmFeedWriter::open() {
+    if (isOpen()) return true;
+
+    // A segment left by an earlier run is replaced, never reused: its readers
+    // keep the old mapping and notice the new createdNs when they reopen
+    shm_unlink(m_name.c_str());
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Shared memory " << m_name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    m_size = sizeof(ShmSegmentHeader) + symbolTableBytes(m_symbolCapacity) + m_ringCount * ringBytes(m_slots);
+    if (ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+        std::cerr << "Shared memory " << m_name << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(m_name.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Shared memory " << m_name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(m_name.c_str());
+        return false;
+    }
+
+    // The new pages are zero, which is also every atomic's starting value
+    auto* bytes = static_cast<char*>(base);
+    m_base = base;
+    m_header = reinterpret_cast<ShmSegmentHeader*>(bytes);
+    m_symbols = reinterpret_cast<BookSymbolName*>(bytes + sizeof(ShmSegmentHeader));
+    char* rings = bytes + sizeof(ShmSegmentHeader) + symbolTableBytes(m_symbolCapacity);
+    m_rings.clear();
+    for (size_t i = 0; i < m_ringCount; i++) {
+        m_rings.push_back(reinterpret_cast<ShmRingHeader*>(rings + i * ringBytes(m_slots)));
+    }
+
+    m_header->version = SHM_VERSION;
+    m_header->ringCount = static_cast<uint32_t>(m_ringCount);
+    m_header->slotsPerRing = m_slots;
+    m_header->symbolCapacity = static_cast<uint32_t>(m_symbolCapacity);
+    m_header->createdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::strncpy(m_header->venue, m_venue.c_str(), sizeof(m_header->venue) - 1);
+
+    // Readers check the magic before anything else
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_header->magic, SHM_MAGIC, sizeof(SHM_MAGIC));
+
+    std::cout << "Publishing " << m_venue << " books to shared memory " << m_name << " (" << m_ringCount
+              << " rings of " << m_slots << " slots)" << std::endl;
+    return true;
+}
+
+void ShmFeedWriter::defineSymbol(uint32_t index, std::string_view name) {
+    if (!m_base || index >= m_symbolCapacity) return;
+    BookSymbolName& symbol = m_symbols[index];
+    std::memset(symbol.name, 0, sizeof(symbol.name));
+    std::memcpy(symbol.name, name.data(), std::min(name.size(), sizeof(symbol.name) - 1));
+
+    uint32_t count = m_header->symbolCount.load(std::memory_order_relaxed);
+    if (index + 1 > count) m_header->symbolCount.store(index + 1, std::memory_order_release);
+}
+
+void ShmFeedWriter::write(size_t ring, const BookRecord& record) {
+    if (!m_base) return;
+    ShmRingHeader* header = m_rings[ring % m_ringCount];
+    uint64_t position = header->head.load(std::memory_order_relaxed);
+    ShmSlot& slot = slotsOf(header)[position & (m_slots - 1)];
+
+    uint64_t words[SHM_WORDS];
+    std::memcpy(words, &record, sizeof(record));
+
+    slot.seq.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < SHM_WORDS; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(2 * position + 2, std::memory_order_release);
+    header->head.store(position + 1, std::memory_order_release);
+}
+
+ShmFeedReader::ShmFeedReader(std::string name) : m_name(std::move(name)) {}
+
+ShmFeedReader::~ShmFeedReader() {
+    if (m_base) munmap(m_base, m_size);
+}
+
+bool ShmFeedReader::open(bool fromStart) {
+    if (isOpen()) return true;
+
+    int fd = shm_open(m_name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat info = {};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmSegmentHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) return false;
+
+    auto* bytes = static_cast<const char*>(base);
+    auto* header = reinterpret_cast<const ShmSegmentHeader*>(bytes);
+    bool valid = std::memcmp(header->magic, SHM_MAGIC, sizeof(SHM_MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    size_t slots = valid ? header->slotsPerRing : 0;
+    valid = valid && header->version == SHM_VERSION && slots && std::has_single_bit(slots) &&
+            size >= sizeof(ShmSegmentHeader) + symbolTableBytes(header->symbolCapacity) +
+                    header->ringCount * ringBytes(slots);
+    if (!valid) {
+        // Not created yet, or from another build
+        munmap(base, size);
+        return false;
+    }
+
+    m_base = base;
+    m_size = size;
+    m_header = header;
+    m_symbols = reinterpret_cast<const BookSymbolName*>(bytes + sizeof(ShmSegmentHeader));
+    const char* rings = bytes + sizeof(ShmSegmentHeader) + symbolTableBytes(header->symbolCapacity);
+    m_rings.clear();
+    m_cursors.clear();
+    for (size_t i = 0; i < header->ringCount; i++) {
+        auto* ring = reinterpret_cast<const ShmRingHeader*>(rings + i * ringBytes(slots));
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        m_rings.push_back(ring);
+        m_cursors.push_back(fromStart ? (head > slots ? head - slots : 0) : head);
+    }
+    return true;
+}
+
+const char* ShmFeedReader::venue() const {
+    return m_header ? m_header->venue : "";
+}
+
+int64_t ShmFeedReader::createdNs() const {
+    return m_header ? m_header->createdNs : 0;
+}
+
+std::string_view ShmFeedReader::symbolName(uint32_t index) const {
+    if (!m_header || index >= m_header->symbolCount.load(std::memory_order_acquire)) return {};
+    const char* name = m_symbols[index].name;
+    return {name, strnlen(name, BOOK_SYMBOL_NAME)};
+}
+
+ShmFeedReader::ReadResult ShmFeedReader::read(size_t ring, BookRecord& out, uint64_t& lost) {
+    const ShmRingHeader* header = m_rings[ring];
+    const uint64_t slots = m_header->slotsPerRing;
+    uint64_t& cursor = m_cursors[ring];
+
+    uint64_t head = header->head.load(std::memory_order_acquire);
+    if (cursor >= head) return ReadResult::Empty;
+
+    // Skips to half a ring behind the writer, so a reader that just caught
+    // up is not lapped again straight away
+    auto lapped = [&](uint64_t newestHead) {
+        uint64_t resume = newestHead > slots / 2 ? newestHead - slots / 2 : 0;
+        resume = std::max(resume, cursor + 1);
+        lost = resume - cursor;
+        cursor = resume;
+        return ReadResult::Lapped;
+    };
+    if (head - cursor > slots) return lapped(head);
+
+    const ShmSlot& slot = slotsOf(header)[cursor & (slots - 1)];
+    const uint64_t expected = 2 * cursor + 2;
+    if (slot.seq.load(std::memory_order_acquire) != expected) {
+        return lapped(header->head.load(std::memory_order_acquire));
+    }
+
+    uint64_t words[SHM_WORDS];
+    for (size_t i = 0; i < SHM_WORDS; i++) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != expected) {
+        return lapped(header->head.load(std::memory_order_acquire));
+    }
+
+    std::memcpy(&out, words, sizeof(out));
+    cursor++;
+    return ReadResult::Ok;
+}
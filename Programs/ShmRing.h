@@ -0,0 +1,160 @@
+//
+// Book updates published through POSIX shared memory to other processes.
+//
+// A segment belongs to one market of one feed handler and holds:
+//   ShmSegmentHeader          magic, layout, symbol count
+//   BookSymbolName[symbols]   names by index, filled as symbols are added
+//   rings[rings]              one per shard worker: a writer cache line with
+//                             the head, then `slots` ShmSlot of 64 bytes
+//
+// Every ring has exactly one writer (the shard worker that owns its symbols)
+// and any number of readers, each with its own cursor; readers never write
+// to the segment, so they cannot slow the writer down or each other. A slot
+// is a small seqlock: the writer marks it odd, stores the record and marks
+// it even with the position it now holds. A reader that falls a full ring
+// behind sees the newer position and reports the gap instead of reading a
+// torn record.
+//
+// Records are normalized levels in fixed-point ticks (BookRecord.h).
+// Snapshots are sent when a book is reset and periodically, so a late or
+// lapped reader resynchronises at the next one.
+//
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BookRecord.h"
+
+constexpr char SHM_MAGIC[8] = {'M', 'E', 'X', 'C', 'S', 'H', 'M', '1'};
+constexpr size_t SHM_CACHE_LINE = 64;
+static_assert(sizeof(BookRecord) + sizeof(uint64_t) == SHM_CACHE_LINE, "A record and its sequence fill one cache line");
+
+struct alignas(SHM_CACHE_LINE) ShmSlot {
+    std::atomic<uint64_t> seq;  // 2 * position + 2 once written, odd while being written
+    std::atomic<uint64_t> words[sizeof(BookRecord) / sizeof(uint64_t)];
+};
+static_assert(sizeof(ShmSlot) == SHM_CACHE_LINE, "Slots are one cache line");
+
+struct alignas(SHM_CACHE_LINE) ShmRingHeader {
+    std::atomic<uint64_t> head;         // Next position to write
+};
+static_assert(sizeof(ShmRingHeader) == SHM_CACHE_LINE, "The head has its own cache line");
+
+struct alignas(SHM_CACHE_LINE) ShmSegmentHeader {
+    char magic[8];                      // Written last by the creator
+    uint32_t version;
+    uint32_t ringCount;
+    uint64_t slotsPerRing;              // Power of two
+    uint32_t symbolCapacity;
+    uint32_t reserved;
+    int64_t createdNs;                  // system_clock, tells restarts apart
+    char venue[16];                     // "spot" / "futures"
+    std::atomic<uint32_t> symbolCount;  // Entries of the symbol table in use
+};
+
+// Owns the segment: creates it (replacing one left by an earlier run),
+// names the symbols and writes the rings
+class ShmFeedWriter {
+public:
+    // name is a POSIX shm name, e.g. "/mexc_spot"
+    ShmFeedWriter(std::string name, std::string_view venue, size_t rings, size_t slotsPerRing = 65536,
+                  size_t symbolCapacity = 256);
+    ~ShmFeedWriter();
+
+    ShmFeedWriter(const ShmFeedWriter&) = delete;
+    ShmFeedWriter& operator=(const ShmFeedWriter&) = delete;
+
+    bool open();
+    bool isOpen() const { return m_base != nullptr; }
+    const std::string& name() const { return m_name; }
+
+    // Names symbol `index`; call before any of its records. One thread only.
+    void defineSymbol(uint32_t index, std::string_view name);
+
+    // Only the owner of `ring` may write to it
+    void write(size_t ring, const BookRecord& record);
+
+private:
+    std::string m_name;
+    std::string m_venue;
+    size_t m_ringCount;
+    size_t m_slots;
+    size_t m_symbolCapacity;
+    void* m_base = nullptr;
+    size_t m_size = 0;
+    ShmSegmentHeader* m_header = nullptr;
+    BookSymbolName* m_symbols = nullptr;
+    std::vector<ShmRingHeader*> m_rings;
+};
+
+// Independent reader of a segment; never writes to it
+class ShmFeedReader {
+public:
+    explicit ShmFeedReader(std::string name);
+    ~ShmFeedReader();
+
+    ShmFeedReader(const ShmFeedReader&) = delete;
+    ShmFeedReader& operator=(const ShmFeedReader&) = delete;
+
+    // Maps the segment and starts at its current end (fromStart: at the oldest
+    // record still in the rings). False while the writer has not created it.
+    bool open(bool fromStart = false);
+    bool isOpen() const { return m_base != nullptr; }
+
+    const char* venue() const;
+    int64_t createdNs() const;
+    // Name of a symbol index seen in a record, "" if unknown
+    std::string_view symbolName(uint32_t index) const;
+
+    // Hands every new record to onRecord(const BookRecord&), up to `max` per
+    // ring. A ring that lapped this reader calls onGap(ring, lost) first and
+    // continues at its oldest record; books of that ring are stale until their
+    // next Clear. Returns the number of records read.
+    template <typename OnRecord, typename OnGap>
+    size_t poll(OnRecord&& onRecord, OnGap&& onGap, size_t max = SIZE_MAX);
+
+    uint64_t lost() const { return m_lost; }
+
+private:
+    enum class ReadResult { Ok, Empty, Lapped };
+    ReadResult read(size_t ring, BookRecord& out, uint64_t& lost);
+
+    std::string m_name;
+    void* m_base = nullptr;
+    size_t m_size = 0;
+    const ShmSegmentHeader* m_header = nullptr;
+    const BookSymbolName* m_symbols = nullptr;
+    std::vector<const ShmRingHeader*> m_rings;
+    std::vector<uint64_t> m_cursors;
+    uint64_t m_lost = 0;
+};
+
+template <typename OnRecord, typename OnGap>
+size_t ShmFeedReader::poll(OnRecord&& onRecord, OnGap&& onGap, size_t max) {
+    size_t total = 0;
+    BookRecord record;
+    for (size_t ring = 0; ring < m_rings.size(); ring++) {
+        for (size_t n = 0; n < max; n++) {
+            uint64_t lost = 0;
+            ReadResult result = read(ring, record, lost);
+            if (result == ReadResult::Empty) break;
+            if (result == ReadResult::Lapped) {
+                m_lost += lost;
+                onGap(ring, lost);
+                continue;
+            }
+            onRecord(static_cast<const BookRecord&>(record));
+            total++;
+        }
+    }
+    return total;
+}
+
+#endif //SHM_RING_H
@@ -0,0 +1,219 @@
+#include "SnapshotSource.h"
+
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/version.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <cstdlib>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = net::ip::tcp;
+
+struct HttpTarget {
+    std::string host;
+    std::string port;
+    std::string target;
+    bool tls = false;
+};
+
+// The objects of one request. The deadline handler keeps them alive, as it
+// may still be queued when the request is over.
+struct HttpRequest {
+    explicit HttpRequest(const net::any_io_executor& executor)
+        : ctx(ssl::context::tlsv12_client), resolver(executor), stream(executor, ctx), deadline(executor) {}
+
+    ssl::context ctx;
+    tcp::resolver resolver;
+    beast::ssl_stream<beast::tcp_stream> stream;    // Only its TCP layer for plain HTTP
+    net::steady_timer deadline;
+    bool expired = false;
+};
+
+// Reads a whole HTTP response; stream is anything Beast can read/write
+template <typename Stream>
+static net::awaitable<bool> exchangeHttp(Stream& stream, const HttpTarget& to, std::string& body) {
+    http::request<http::empty_body> req{http::verb::get, to.target, 11};
+    req.set(http::field::host, to.host);
+    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    co_await http::async_write(stream, req, net::use_awaitable);
+
+    beast::flat_buffer buffer;
+    http::response<http::string_body> res;
+    co_await http::async_read(stream, buffer, res, net::use_awaitable);
+
+    if (res.result() != http::status::ok) {
+        std::cerr << "Snapshot request " << to.target << " failed: " << res.result_int() << std::endl;
+        co_return false;
+    }
+    body = std::move(res.body());
+    co_return true;
+}
+
+static net::awaitable<bool> exchange(HttpRequest& request, const HttpTarget& to, std::string& body) {
+    auto const results = co_await request.resolver.async_resolve(to.host, to.port, net::use_awaitable);
+    co_await beast::get_lowest_layer(request.stream).async_connect(results, net::use_awaitable);
+    if (!to.tls) co_return co_await exchangeHttp(beast::get_lowest_layer(request.stream), to, body);
+
+    if (!SSL_set_tlsext_host_name(request.stream.native_handle(), to.host.c_str())) {
+        throw beast::system_error(
+            beast::error_code(
+                static_cast<int>(::ERR_get_error()),
+                net::error::get_ssl_category()
+            )
+        );
+    }
+    co_await request.stream.async_handshake(ssl::stream_base::client, net::use_awaitable);
+    // No TLS shutdown: servers often just drop the connection, and the
+    // request would wait on it
+    co_return co_await exchangeHttp(request.stream, to, body);
+}
+
+// Runs one GET and calls done exactly once. The deadline covers the whole
+// request, resolve included, which the stream's own timeouts do not.
+static net::awaitable<void> fetchHttp(HttpTarget to, SnapshotHandler done) {
+    auto request = std::make_shared<HttpRequest>(co_await net::this_coro::executor);
+    request->ctx.set_verify_mode(ssl::verify_none);
+    request->deadline.expires_after(SNAPSHOT_TIMEOUT);
+    request->deadline.async_wait([request](beast::error_code ec) {
+        if (ec) return;
+        request->expired = true;
+        request->resolver.cancel();
+        beast::get_lowest_layer(request->stream).close();
+    });
+
+    bool ok = false;
+    std::string body;
+    try {
+        ok = co_await exchange(*request, to, body);
+    }
+    catch (std::exception const& e) {
+        if (request->expired) {
+            std::cerr << "Snapshot request " << to.target << " timed out" << std::endl;
+        } else {
+            std::cerr << "Snapshot request error: " << e.what() << std::endl;
+        }
+    }
+    request->deadline.cancel();
+    done(ok, std::move(body));
+}
+
+// Blocking form for the tools: the request on a private io_context
+static bool fetchHttpBlocking(HttpTarget to, std::string& body) {
+    net::io_context ioc;
+    bool ok = false;
+    net::co_spawn(ioc, fetchHttp(std::move(to), [&ok, &body](bool fetched, std::string text) {
+        ok = fetched;
+        body = std::move(text);
+    }), net::detached);
+    ioc.run();
+    return ok;
+}
+
+static std::string withSymbol(std::string text, const std::string& symbol) {
+    size_t pos = text.find("{symbol}");
+    if (pos != std::string::npos) text.replace(pos, 8, symbol);
+    return text;
+}
+
+SnapshotSource makeFileSnapshotSource(std::string pathFormat) {
+    return [pathFormat = std::move(pathFormat)](const std::string& symbol, std::string& body) {
+        std::string path = withSymbol(pathFormat, symbol);
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Snapshot file " << path << " not found" << std::endl;
+            return false;
+        }
+        body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    };
+}
+
+// "http://host[:port]/target" or "https://host[:port]/target", the target
+// still holding "{symbol}"
+static bool parseHttpSpec(const std::string& spec, HttpTarget& to) {
+    to.tls = spec.rfind("https://", 0) == 0;
+    if (!to.tls && spec.rfind("http://", 0) != 0) return false;
+
+    std::string rest = spec.substr(to.tls ? 8 : 7);
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    to.target = slash == std::string::npos ? "/" : rest.substr(slash);
+    size_t colon = authority.find(':');
+    to.host = authority.substr(0, colon);
+    to.port = colon == std::string::npos ? (to.tls ? "443" : "80") : authority.substr(colon + 1);
+    return true;
+}
+
+SnapshotSource makeSnapshotSource(const std::string& spec) {
+    if (spec.rfind("file:", 0) == 0) return makeFileSnapshotSource(spec.substr(5));
+
+    HttpTarget base;
+    if (!parseHttpSpec(spec, base)) return nullptr;
+    return [base](const std::string& symbol, std::string& body) {
+        HttpTarget to = base;
+        to.target = withSymbol(base.target, symbol);
+        return fetchHttpBlocking(std::move(to), body);
+    };
+}
+
+SnapshotSource snapshotSourceFromEnv(const char* envVar, SnapshotSource fallback) {
+    const char* spec = std::getenv(envVar);
+    if (spec == nullptr || *spec == '\0') return fallback;
+
+    SnapshotSource source = makeSnapshotSource(spec);
+    if (!source) {
+        std::cerr << envVar << ": unsupported snapshot source '" << spec << "'" << std::endl;
+        return fallback;
+    }
+    std::cout << "Using snapshot source " << spec << std::endl;
+    return source;
+}
+
+AsyncSnapshotSource makeAsyncSnapshotSource(net::io_context& ioc, const std::string& spec) {
+    if (spec.rfind("file:", 0) == 0) {
+        return [&ioc, file = makeFileSnapshotSource(spec.substr(5))](const std::string& symbol, SnapshotHandler done) {
+            std::string body;
+            bool ok = file(symbol, body);
+            net::post(ioc, [done = std::move(done), ok, body = std::move(body)]() mutable {
+                done(ok, std::move(body));
+            });
+        };
+    }
+
+    HttpTarget base;
+    if (!parseHttpSpec(spec, base)) return nullptr;
+    return [&ioc, base](const std::string& symbol, SnapshotHandler done) {
+        HttpTarget to = base;
+        to.target = withSymbol(base.target, symbol);
+        net::co_spawn(ioc, fetchHttp(std::move(to), std::move(done)), net::detached);
+    };
+}
+
+AsyncSnapshotSource asyncSnapshotSourceFromEnv(net::io_context& ioc, const char* envVar,
+                                               const std::string& fallbackSpec) {
+    const char* spec = std::getenv(envVar);
+    if (spec == nullptr || *spec == '\0') return makeAsyncSnapshotSource(ioc, fallbackSpec);
+
+    AsyncSnapshotSource source = makeAsyncSnapshotSource(ioc, spec);
+    if (!source) {
+        std::cerr << envVar << ": unsupported snapshot source '" << spec << "'" << std::endl;
+        return makeAsyncSnapshotSource(ioc, fallbackSpec);
+    }
+    std::cout << "Using snapshot source " << spec << std::endl;
+    return source;
+}
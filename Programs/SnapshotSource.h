@@ -0,0 +1,55 @@
+//
+// Sources of depth snapshots used to (re)synchronise incremental books.
+//
+// A source fills `body` with the raw JSON of a snapshot for `symbol` and
+// returns false on failure. The feed only depends on this signature, so the
+// REST call can be swapped for anything that produces the same JSON.
+//
+// The live feed uses the asynchronous form instead: the request runs on the
+// io thread and hands its result to a callback, so the shard that needs the
+// snapshot keeps serving its other symbols meanwhile. Every HTTP request,
+// blocking or not, is abandoned after SNAPSHOT_TIMEOUT.
+//
+
+#ifndef SNAPSHOT_SOURCE_H
+#define SNAPSHOT_SOURCE_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include <boost/asio/io_context.hpp>
+
+using SnapshotSource = std::function<bool(const std::string& symbol, std::string& body)>;
+
+// Runs on the io_context's thread once the request is over; body is only
+// meaningful when ok
+using SnapshotHandler = std::function<void(bool ok, std::string body)>;
+using AsyncSnapshotSource = std::function<void(const std::string& symbol, SnapshotHandler done)>;
+
+// Whole request: resolve, connect, handshake, write and read
+constexpr std::chrono::seconds SNAPSHOT_TIMEOUT{5};
+
+// In the formats below "{symbol}" is replaced by the requested symbol.
+
+// Reads the snapshot from a local file
+SnapshotSource makeFileSnapshotSource(std::string pathFormat);
+
+// Builds a source from "file:<path>", "http://host[:port]/target" or
+// "https://host[:port]/target". Returns an empty function for anything else.
+SnapshotSource makeSnapshotSource(const std::string& spec);
+
+// Returns makeSnapshotSource(getenv(envVar)) when the variable is set and
+// valid, otherwise the given default
+SnapshotSource snapshotSourceFromEnv(const char* envVar, SnapshotSource fallback);
+
+// Asynchronous sources on `ioc`, from the same specs. File sources read the
+// file at once and complete through the io_context.
+AsyncSnapshotSource makeAsyncSnapshotSource(boost::asio::io_context& ioc, const std::string& spec);
+
+// makeAsyncSnapshotSource(getenv(envVar)) when the variable is set and valid,
+// otherwise the one of fallbackSpec
+AsyncSnapshotSource asyncSnapshotSourceFromEnv(boost::asio::io_context& ioc, const char* envVar,
+                                               const std::string& fallbackSpec);
+
+#endif //SNAPSHOT_SOURCE_H
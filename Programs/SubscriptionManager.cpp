@@ -0,0 +1,120 @@
+#include "SubscriptionManager.h"
+#include "LatencyHistogram.h"
+#include "MexcParser.h"
+
+#include <boost/asio/post.hpp>
+#include <iostream>
+
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+
+SubscriptionManager::SubscriptionManager(net::io_context& ioc, ssl::context& ctx, Venue venue,
+                                         ShardPool& shards, size_t maxSymbols, AddHandler onAdd)
+    : m_ioc(ioc),
+      m_ctx(ctx),
+      m_venue(std::move(venue)),
+      m_shards(shards),
+      m_maxSymbols(maxSymbols),
+      m_onAdd(std::move(onAdd)) {}
+
+void SubscriptionManager::add(std::string symbol, AddedHandler done) {
+    net::post(m_ioc, [this, symbol = std::move(symbol), done = std::move(done)]() mutable {
+        addOnIo(std::move(symbol), done);
+    });
+}
+
+void SubscriptionManager::addList(std::string_view symbols) {
+    while (!symbols.empty()) {
+        size_t comma = symbols.find(',');
+        std::string_view symbol = symbols.substr(0, comma);
+        while (!symbol.empty() && symbol.front() == ' ') symbol.remove_prefix(1);
+        while (!symbol.empty() && symbol.back() == ' ') symbol.remove_suffix(1);
+        if (!symbol.empty()) add(std::string(symbol));
+        if (comma == std::string_view::npos) break;
+        symbols.remove_prefix(comma + 1);
+    }
+}
+
+void SubscriptionManager::addOnIo(std::string symbol, const AddedHandler& done) {
+    auto found = m_index.find(symbol);
+    if (found != m_index.end()) {
+        if (done) done(found->second);
+        return;
+    }
+    if (m_symbols.size() >= m_maxSymbols) {
+        std::cerr << "Symbol limit of " << m_maxSymbols << " reached, not adding " << symbol << std::endl;
+        return;
+    }
+
+    uint32_t index = static_cast<uint32_t>(m_symbols.size());
+    m_symbols.push_back(symbol);
+    m_index.emplace(symbol, index);
+    m_onAdd(index, symbol);
+
+    Connection& connection = connectionWithRoom();
+    connection.symbols.push_back(index);
+
+    if (connection.session) {
+        // Live connection: subscribe just this symbol, the others keep streaming
+        reset(index, connection.stream);
+        for (std::string& frame : m_venue.subscribe(symbol)) {
+            connection.session->send(std::move(frame));
+        }
+    } else {
+        uint16_t stream = connection.stream;
+        connection.session = std::make_unique<WebSocketSession>(
+            m_ioc, m_ctx, m_venue.options,
+            [this, &connection] { return onOpen(connection); },
+            [this, stream](std::string_view text) { route(stream, text); });
+        connection.session->start();
+    }
+
+    if (done) done(index);
+}
+
+SubscriptionManager::Connection& SubscriptionManager::connectionWithRoom() {
+    for (Connection& connection : m_connections) {
+        if (connection.symbols.size() < m_venue.symbolsPerConnection) return connection;
+    }
+    Connection& connection = m_connections.emplace_back();
+    connection.stream = static_cast<uint16_t>(m_connections.size() - 1);
+    return connection;
+}
+
+std::vector<std::string> SubscriptionManager::onOpen(Connection& connection) {
+    std::vector<std::string> frames;
+    for (uint32_t index : connection.symbols) {
+        reset(index, connection.stream);
+        for (std::string& frame : m_venue.subscribe(m_symbols[index])) {
+            frames.push_back(std::move(frame));
+        }
+    }
+    return frames;
+}
+
+// Drops the symbol's book ahead of the frames of its new stream. The journal
+// gets a marker at the same point so a replay drops it too.
+void SubscriptionManager::reset(uint32_t index, uint16_t stream) {
+    if (m_journal) m_journal->append(m_symbols[index], steadyNowNs(), 0, stream, JOURNAL_RESET);
+    m_shards.post(index, ShardPool::Kind::Reset);
+}
+
+void SubscriptionManager::route(uint16_t stream, std::string_view text) {
+    // Same clock as journalNowNs(), so one stamp serves the journal and the latency stages
+    int64_t recvNs = steadyNowNs();
+    if (m_journal) {
+        int64_t exchangeMs = 0;
+        if (!m_venue.timestampKey.empty()) peekInteger(text, m_venue.timestampKey, exchangeMs);
+        m_journal->append(text, recvNs, exchangeMs, stream);
+    }
+
+    std::string_view symbol;
+    if (peekString(text, m_venue.symbolKey, symbol)) {
+        auto found = m_index.find(symbol);
+        if (found != m_index.end()) {
+            m_shards.post(found->second, ShardPool::Kind::Message, text, recvNs);
+            return;
+        }
+    }
+    if (m_venue.other) m_venue.other(text);
+}
@@ -0,0 +1,99 @@
+//
+// Multiplexes many symbols over a small pool of websocket connections.
+//
+// Symbols are packed onto connections up to a per-connection limit; a new
+// symbol is subscribed on a live connection without disturbing the others,
+// and a new connection is only opened when every existing one is full.
+// Incoming frames are routed by their symbol member to the ShardPool, which
+// owns the per-symbol books. When a connection (re)opens, each of its symbols
+// first gets a Reset so the owning worker drops the stale book.
+//
+// Everything except add() runs on the io_context thread. With a journal set,
+// every received frame is captured before it is routed, and every Reset is
+// recorded as a JOURNAL_RESET marker.
+//
+
+#ifndef SUBSCRIPTION_MANAGER_H
+#define SUBSCRIPTION_MANAGER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "ShardPool.h"
+#include "FrameJournal.h"
+#include "WebSocketSession.h"
+
+class SubscriptionManager {
+public:
+    struct Venue {
+        WebSocketSession::Options options;
+        size_t symbolsPerConnection = 20;
+        std::string symbolKey;      // Top-level member carrying the symbol: "s" (spot) / "symbol" (futures)
+        std::string timestampKey;   // Exchange time in ms: "t" (spot) / "ts" (futures)
+        // Frames that subscribe one symbol
+        std::function<std::vector<std::string>(const std::string& symbol)> subscribe;
+        // Frames without a known symbol (replies, pongs, errors)
+        std::function<void(std::string_view text)> other;
+    };
+
+    // Called on the io thread when a symbol is first seen, before any of its
+    // frames is posted to the shards
+    using AddHandler = std::function<void(uint32_t index, const std::string& symbol)>;
+    // Called on the io thread once add() has placed the symbol
+    using AddedHandler = std::function<void(uint32_t index)>;
+
+    SubscriptionManager(boost::asio::io_context& ioc, boost::asio::ssl::context& ctx, Venue venue,
+                        ShardPool& shards, size_t maxSymbols, AddHandler onAdd);
+
+    // Thread safe. Adding a symbol that is already tracked only calls done.
+    void add(std::string symbol, AddedHandler done = {});
+    // Adds every symbol of a comma separated list
+    void addList(std::string_view symbols);
+
+    // Captures every frame from now on; the journal must already be open.
+    // Call before add() so it is set before any frame arrives.
+    void setJournal(FrameJournal* journal) { m_journal = journal; }
+
+    size_t symbolCount() const { return m_symbols.size(); }
+    size_t connectionCount() const { return m_connections.size(); }
+
+private:
+    struct Connection {
+        std::unique_ptr<WebSocketSession> session;
+        std::vector<uint32_t> symbols;
+        uint16_t stream = 0;        // Position in m_connections, the journal's stream id
+    };
+
+    // Lets the symbol map be searched with the string_view taken from a frame
+    struct SymbolHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    void addOnIo(std::string symbol, const AddedHandler& done);
+    Connection& connectionWithRoom();
+    std::vector<std::string> onOpen(Connection& connection);
+    void reset(uint32_t index, uint16_t stream);
+    void route(uint16_t stream, std::string_view text);
+
+    boost::asio::io_context& m_ioc;
+    boost::asio::ssl::context& m_ctx;
+    Venue m_venue;
+    ShardPool& m_shards;
+    size_t m_maxSymbols;
+    AddHandler m_onAdd;
+    FrameJournal* m_journal = nullptr;
+
+    std::unordered_map<std::string, uint32_t, SymbolHash, std::equal_to<>> m_index;
+    std::vector<std::string> m_symbols;
+    std::deque<Connection> m_connections;   // Deque: sessions keep pointers to their entry
+};
+
+#endif //SUBSCRIPTION_MANAGER_H
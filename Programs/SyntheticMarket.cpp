@@ -0,0 +1,359 @@
+#include "SyntheticMarket.h"
+#include "FixedPoint.h"
+
+#include <algorithm>
+
+SyntheticBook::SyntheticBook(std::string symbol, Options options)
+    : m_symbol(std::move(symbol)),
+      m_options(options),
+      m_rng(options.seed),
+      m_tradeRng(options.seed ^ 0x9e3779b97f4a7c15ull),
+      m_mid(options.startPrice) {
+    if (m_options.levels == 0) m_options.levels = 1;
+    for (size_t d = 1; d <= m_options.levels; d++) {
+        m_bids[m_mid - static_cast<int64_t>(d)] = randomQty();
+        m_asks[m_mid + static_cast<int64_t>(d)] = randomQty();
+    }
+    m_version = 1000 + (m_rng() % 1000);
+}
+
+int64_t SyntheticBook::randomQty() {
+    // Up to 50 units, never zero
+    int64_t range = 50 * FIXED_POW10[std::clamp(m_options.qtyDecimals, 0, FIXED_MAX_DECIMALS)];
+    return static_cast<int64_t>(m_rng() % static_cast<uint64_t>(range)) + 1;
+}
+
+void SyntheticBook::set(Side side, int64_t price, int64_t qty) {
+    if (side == Side::Bid) {
+        if (qty == 0) m_bids.erase(price);
+        else m_bids[price] = qty;
+    } else {
+        if (qty == 0) m_asks.erase(price);
+        else m_asks[price] = qty;
+    }
+    m_changes.push_back({side, price, qty});
+}
+
+void SyntheticBook::trade(int64_t price, bool takerBuy) {
+    if (price == 0) return;     // That side is empty
+    // Up to 5 units, never zero
+    int64_t range = 5 * FIXED_POW10[std::clamp(m_options.qtyDecimals, 0, FIXED_MAX_DECIMALS)];
+    m_trades.push_back({price, static_cast<int64_t>(m_tradeRng() % static_cast<uint64_t>(range)) + 1, takerBuy});
+}
+
+const std::vector<SyntheticBook::Change>& SyntheticBook::step() {
+    m_changes.clear();
+    m_trades.clear();
+    m_version++;
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    int64_t levels = static_cast<int64_t>(m_options.levels);
+
+    // A few trades at the touch; a mid move below takes the touch out with one more
+    size_t prints = m_tradeRng() % 4;
+    for (size_t k = 0; k < prints; k++) {
+        bool takerBuy = m_tradeRng() & 1;
+        trade(takerBuy ? bestAsk() : bestBid(), takerBuy);
+    }
+
+    if (unit(m_rng) < m_options.moveProbability) {
+        // Keep bids below the mid and asks above it, `levels` deep on each side
+        if (m_rng() & 1) {
+            trade(bestAsk(), true);
+            m_mid++;
+            if (m_asks.count(m_mid)) set(Side::Ask, m_mid, 0);
+            set(Side::Bid, m_mid - 1, randomQty());
+            if (m_bids.count(m_mid - 1 - levels)) set(Side::Bid, m_mid - 1 - levels, 0);
+            set(Side::Ask, m_mid + levels, randomQty());
+        } else {
+            trade(bestBid(), false);
+            m_mid--;
+            if (m_bids.count(m_mid)) set(Side::Bid, m_mid, 0);
+            set(Side::Ask, m_mid + 1, randomQty());
+            if (m_asks.count(m_mid + 1 + levels)) set(Side::Ask, m_mid + 1 + levels, 0);
+            set(Side::Bid, m_mid - levels, randomQty());
+        }
+    }
+
+    for (size_t k = 0; k < m_options.churn; k++) {
+        Side side = (m_rng() & 1) ? Side::Bid : Side::Ask;
+        // Levels near the top change more often than deep ones
+        int64_t distance = 1 + static_cast<int64_t>(std::min(m_rng() % m_options.levels, m_rng() % m_options.levels));
+        int64_t price = side == Side::Bid ? m_mid - distance : m_mid + distance;
+        int64_t qty = m_rng() % 5 == 0 ? 0 : randomQty();
+        set(side, price, qty);
+    }
+    return m_changes;
+}
+
+void SyntheticBook::forEachLevel(Side side, size_t maxLevels,
+                                 const std::function<void(int64_t, int64_t)>& fn) const {
+    size_t n = 0;
+    if (side == Side::Bid) {
+        for (auto it = m_bids.begin(); it != m_bids.end() && n < maxLevels; ++it, ++n) fn(it->first, it->second);
+    } else {
+        for (auto it = m_asks.begin(); it != m_asks.end() && n < maxLevels; ++it, ++n) fn(it->first, it->second);
+    }
+}
+
+static void appendFixed(std::string& out, int64_t raw, int decimals) {
+    char buffer[32];
+    int length = formatFixed(buffer, sizeof(buffer), raw, decimals, decimals);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+static void appendInteger(std::string& out, int64_t value) {
+    out += std::to_string(value);
+}
+
+// Spot levels are objects of strings: {"p":"3000.01","v":"1.5"}
+static void appendSpotLevel(std::string& out, const SyntheticBook& book, int64_t price, int64_t qty) {
+    out += "{\"p\":\"";
+    appendFixed(out, price, book.options().priceDecimals);
+    out += "\",\"v\":\"";
+    appendFixed(out, qty, book.options().qtyDecimals);
+    out += "\"}";
+}
+
+// Futures levels are arrays of numbers: [price, volume, orders]
+static void appendFuturesLevel(std::string& out, const SyntheticBook& book, int64_t price, int64_t qty) {
+    out += '[';
+    appendFixed(out, price, book.options().priceDecimals);
+    out += ',';
+    appendFixed(out, qty, book.options().qtyDecimals);
+    out += ",1]";
+}
+
+// Snapshot levels are arrays of strings: ["3000.01","1.5"]
+static void appendSnapshotLevel(std::string& out, const SyntheticBook& book, int64_t price, int64_t qty) {
+    out += "[\"";
+    appendFixed(out, price, book.options().priceDecimals);
+    out += "\",\"";
+    appendFixed(out, qty, book.options().qtyDecimals);
+    out += "\"]";
+}
+
+using LevelWriter = void (*)(std::string&, const SyntheticBook&, int64_t, int64_t);
+
+static void appendChanges(std::string& out, const char* name, Side side, const SyntheticBook& book,
+                          const std::vector<SyntheticBook::Change>& changes, LevelWriter write) {
+    out += '"';
+    out += name;
+    out += "\":[";
+    bool first = true;
+    for (const SyntheticBook::Change& change : changes) {
+        if (change.side != side) continue;
+        if (!first) out += ',';
+        write(out, book, change.price, change.qty);
+        first = false;
+    }
+    out += ']';
+}
+
+static void appendLevels(std::string& out, const char* name, Side side, const SyntheticBook& book, size_t depth,
+                         LevelWriter write) {
+    out += '"';
+    out += name;
+    out += "\":[";
+    bool first = true;
+    book.forEachLevel(side, depth, [&](int64_t price, int64_t qty) {
+        if (!first) out += ',';
+        write(out, book, price, qty);
+        first = false;
+    });
+    out += ']';
+}
+
+std::string spotDepthDeltaFrame(const SyntheticBook& book, const std::vector<SyntheticBook::Change>& changes,
+                                int64_t timeMs) {
+    bool hasAsks = std::any_of(changes.begin(), changes.end(), [](auto& c) { return c.side == Side::Ask; });
+    bool hasBids = std::any_of(changes.begin(), changes.end(), [](auto& c) { return c.side == Side::Bid; });
+
+    std::string out;
+    out.reserve(160 + changes.size() * 40);
+    out += "{\"c\":\"spot@public.increase.depth.v3.api@";
+    out += book.symbol();
+    out += "\",\"d\":{";
+    // Like MEXC, a side without changes is left out
+    if (hasAsks || !hasBids) {
+        appendChanges(out, "asks", Side::Ask, book, changes, appendSpotLevel);
+        if (hasBids) out += ',';
+    }
+    if (hasBids) appendChanges(out, "bids", Side::Bid, book, changes, appendSpotLevel);
+    out += ",\"e\":\"spot@public.increase.depth.v3.api\",\"r\":\"";
+    appendInteger(out, static_cast<int64_t>(book.version()));
+    out += "\"},\"s\":\"";
+    out += book.symbol();
+    out += "\",\"t\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
+
+std::string spotLimitDepthFrame(const SyntheticBook& book, size_t depth, int64_t timeMs) {
+    std::string out;
+    out.reserve(160 + depth * 80);
+    out += "{\"c\":\"spot@public.limit.depth.v3.api@";
+    out += book.symbol();
+    out += '@';
+    appendInteger(out, static_cast<int64_t>(depth));
+    out += "\",\"d\":{";
+    appendLevels(out, "asks", Side::Ask, book, depth, appendSpotLevel);
+    out += ',';
+    appendLevels(out, "bids", Side::Bid, book, depth, appendSpotLevel);
+    out += ",\"e\":\"spot@public.limit.depth.v3.api\",\"r\":\"";
+    appendInteger(out, static_cast<int64_t>(book.version()));
+    out += "\"},\"s\":\"";
+    out += book.symbol();
+    out += "\",\"t\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
+
+std::string spotBookTickerFrame(const SyntheticBook& book, int64_t timeMs) {
+    int priceDecimals = book.options().priceDecimals;
+    int qtyDecimals = book.options().qtyDecimals;
+
+    std::string out;
+    out.reserve(200);
+    out += "{\"c\":\"spot@public.bookTicker.v3.api@";
+    out += book.symbol();
+    out += "\",\"d\":{\"A\":\"";
+    appendFixed(out, book.bestAskQty(), qtyDecimals);
+    out += "\",\"B\":\"";
+    appendFixed(out, book.bestBidQty(), qtyDecimals);
+    out += "\",\"a\":\"";
+    appendFixed(out, book.bestAsk(), priceDecimals);
+    out += "\",\"b\":\"";
+    appendFixed(out, book.bestBid(), priceDecimals);
+    out += "\"},\"s\":\"";
+    out += book.symbol();
+    out += "\",\"t\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
+
+std::string spotDepthSnapshot(const SyntheticBook& book, size_t limit) {
+    std::string out;
+    out.reserve(64 + limit * 60);
+    out += "{\"lastUpdateId\":";
+    appendInteger(out, static_cast<int64_t>(book.version()));
+    out += ',';
+    appendLevels(out, "bids", Side::Bid, book, limit, appendSnapshotLevel);
+    out += ',';
+    appendLevels(out, "asks", Side::Ask, book, limit, appendSnapshotLevel);
+    out += '}';
+    return out;
+}
+
+std::string spotDealsFrame(const SyntheticBook& book, int64_t timeMs) {
+    if (book.trades().empty()) return {};
+
+    std::string out;
+    out.reserve(160 + book.trades().size() * 64);
+    out += "{\"c\":\"spot@public.deals.v3.api@";
+    out += book.symbol();
+    out += "\",\"d\":{\"deals\":[";
+    bool first = true;
+    for (const SyntheticBook::Trade& trade : book.trades()) {
+        if (!first) out += ',';
+        out += "{\"S\":";
+        out += trade.takerBuy ? '1' : '2';
+        out += ",\"p\":\"";
+        appendFixed(out, trade.price, book.options().priceDecimals);
+        out += "\",\"t\":";
+        appendInteger(out, timeMs);
+        out += ",\"v\":\"";
+        appendFixed(out, trade.qty, book.options().qtyDecimals);
+        out += "\"}";
+        first = false;
+    }
+    out += "],\"e\":\"spot@public.deals.v3.api\"},\"s\":\"";
+    out += book.symbol();
+    out += "\",\"t\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
+
+std::string futuresDepthDeltaFrame(const SyntheticBook& book, const std::vector<SyntheticBook::Change>& changes,
+                                   int64_t timeMs) {
+    std::string out;
+    out.reserve(128 + changes.size() * 32);
+    out += "{\"channel\":\"push.depth\",\"data\":{";
+    appendChanges(out, "asks", Side::Ask, book, changes, appendFuturesLevel);
+    out += ',';
+    appendChanges(out, "bids", Side::Bid, book, changes, appendFuturesLevel);
+    out += ",\"version\":";
+    appendInteger(out, static_cast<int64_t>(book.version()));
+    out += "},\"symbol\":\"";
+    out += book.symbol();
+    out += "\",\"ts\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
+
+std::string futuresDepthFullFrame(const SyntheticBook& book, size_t depth, int64_t timeMs) {
+    std::string out;
+    out.reserve(128 + depth * 64);
+    out += "{\"channel\":\"push.depth.full\",\"data\":{";
+    appendLevels(out, "asks", Side::Ask, book, depth, appendFuturesLevel);
+    out += ',';
+    appendLevels(out, "bids", Side::Bid, book, depth, appendFuturesLevel);
+    out += ",\"version\":";
+    appendInteger(out, static_cast<int64_t>(book.version()));
+    out += "},\"symbol\":\"";
+    out += book.symbol();
+    out += "\",\"ts\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
+
+std::string futuresDepthSnapshot(const SyntheticBook& book, size_t limit, int64_t timeMs) {
+    std::string out;
+    out.reserve(96 + limit * 64);
+    out += "{\"success\":true,\"code\":0,\"data\":{";
+    appendLevels(out, "asks", Side::Ask, book, limit, appendFuturesLevel);
+    out += ',';
+    appendLevels(out, "bids", Side::Bid, book, limit, appendFuturesLevel);
+    out += ",\"version\":";
+    appendInteger(out, static_cast<int64_t>(book.version()));
+    out += ",\"timestamp\":";
+    appendInteger(out, timeMs);
+    out += "}}";
+    return out;
+}
+
+// One push.deal per step; a step with several prints sends them as an array
+std::string futuresDealFrame(const SyntheticBook& book, int64_t timeMs) {
+    const std::vector<SyntheticBook::Trade>& trades = book.trades();
+    if (trades.empty()) return {};
+
+    std::string out;
+    out.reserve(96 + trades.size() * 64);
+    out += "{\"channel\":\"push.deal\",\"data\":";
+    if (trades.size() > 1) out += '[';
+    for (size_t i = 0; i < trades.size(); i++) {
+        if (i) out += ',';
+        out += "{\"M\":1,\"O\":3,\"T\":";
+        out += trades[i].takerBuy ? '1' : '2';
+        out += ",\"p\":";
+        appendFixed(out, trades[i].price, book.options().priceDecimals);
+        out += ",\"t\":";
+        appendInteger(out, timeMs);
+        out += ",\"v\":";
+        appendFixed(out, trades[i].qty, book.options().qtyDecimals);
+        out += '}';
+    }
+    if (trades.size() > 1) out += ']';
+    out += ",\"symbol\":\"";
+    out += book.symbol();
+    out += "\",\"ts\":";
+    appendInteger(out, timeMs);
+    out += '}';
+    return out;
+}
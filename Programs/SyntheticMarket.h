@@ -0,0 +1,102 @@
+//
+// Random-walk order books and the MEXC wire messages that describe them.
+//
+// Each step moves the mid price by at most one tick and rewrites a number
+// of levels around it (the churn). The levels that changed are kept so they
+// can be sent as a diff-depth message; the book itself can be written out
+// as a limited-depth push, a bookTicker or a REST snapshot, in the spot and
+// futures formats the client parses. A step also prints trades at the touch
+// (a mid move is the touch being taken out), sent as deals messages; they
+// come from their own generator, so the book steps are the same with or
+// without anyone reading the trades.
+//
+
+#ifndef SYNTHETIC_MARKET_H
+#define SYNTHETIC_MARKET_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "OrderBookEngine.h"
+
+class SyntheticBook {
+public:
+    struct Options {
+        int priceDecimals = 2;
+        int qtyDecimals = 4;
+        int64_t startPrice = 300000;        // In ticks of 10^-priceDecimals
+        size_t levels = 200;                // Levels kept on each side
+        size_t churn = 4;                   // Levels rewritten per step
+        double moveProbability = 0.3;       // Chance of a one tick mid move per step
+        uint64_t seed = 1;
+    };
+
+    struct Change {
+        Side side;
+        int64_t price;
+        int64_t qty;                        // 0 removes the level
+    };
+
+    struct Trade {
+        int64_t price;
+        int64_t qty;
+        bool takerBuy;                      // Lifted the ask, or hit the bid
+    };
+
+    SyntheticBook(std::string symbol, Options options);
+
+    // Advances the book by one update and returns the levels it changed
+    const std::vector<Change>& step();
+    // Trades printed by the last step, often none
+    const std::vector<Trade>& trades() const { return m_trades; }
+
+    const std::string& symbol() const { return m_symbol; }
+    const Options& options() const { return m_options; }
+    uint64_t version() const { return m_version; }
+    int64_t bestBid() const { return m_bids.empty() ? 0 : m_bids.begin()->first; }
+    int64_t bestAsk() const { return m_asks.empty() ? 0 : m_asks.begin()->first; }
+    int64_t bestBidQty() const { return m_bids.empty() ? 0 : m_bids.begin()->second; }
+    int64_t bestAskQty() const { return m_asks.empty() ? 0 : m_asks.begin()->second; }
+
+    // Calls fn(price, qty) for up to maxLevels levels from the best price outward
+    void forEachLevel(Side side, size_t maxLevels, const std::function<void(int64_t, int64_t)>& fn) const;
+
+private:
+    void set(Side side, int64_t price, int64_t qty);
+    int64_t randomQty();
+    void trade(int64_t price, bool takerBuy);
+
+    std::string m_symbol;
+    Options m_options;
+    std::mt19937_64 m_rng;
+    std::mt19937_64 m_tradeRng;
+    std::map<int64_t, int64_t, std::greater<>> m_bids;
+    std::map<int64_t, int64_t> m_asks;
+    int64_t m_mid;                          // Bids sit below it, asks above
+    uint64_t m_version = 0;
+    std::vector<Change> m_changes;
+    std::vector<Trade> m_trades;
+};
+
+// Spot frames. "t" is the exchange time in milliseconds.
+std::string spotDepthDeltaFrame(const SyntheticBook& book, const std::vector<SyntheticBook::Change>& changes,
+                                int64_t timeMs);
+std::string spotLimitDepthFrame(const SyntheticBook& book, size_t depth, int64_t timeMs);
+std::string spotBookTickerFrame(const SyntheticBook& book, int64_t timeMs);
+std::string spotDepthSnapshot(const SyntheticBook& book, size_t limit);
+// The trades of the last step; empty when it printed none
+std::string spotDealsFrame(const SyntheticBook& book, int64_t timeMs);
+
+// Futures frames
+std::string futuresDepthDeltaFrame(const SyntheticBook& book, const std::vector<SyntheticBook::Change>& changes,
+                                   int64_t timeMs);
+std::string futuresDepthFullFrame(const SyntheticBook& book, size_t depth, int64_t timeMs);
+std::string futuresDepthSnapshot(const SyntheticBook& book, size_t limit, int64_t timeMs);
+std::string futuresDealFrame(const SyntheticBook& book, int64_t timeMs);
+
+#endif //SYNTHETIC_MARKET_H
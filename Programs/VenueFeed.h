@@ -0,0 +1,617 @@
+//
+// The feed of one market: its subscriptions, shard workers, books and
+// published snapshots, parameterized by a venue policy (MexcVenues.h).
+//
+// Each venue is its own instance with its own connections and workers, so
+// spot and futures run side by side in one process on a shared io_context.
+// The per-frame path (apply, publish) calls the policy directly; nothing in
+// it is virtual.
+//
+// Threads: start(), stop() and the constructor run on the owner; everything
+// the subscription manager does runs on the io thread; a symbol's book is
+// only touched by its shard worker. Other threads read a symbol through its
+// snapshot, found with the index add() reports.
+//
+// Every publish can also leave the process as BookRecord (BookRecord.h): the
+// levels of the published top that changed, and a full snapshot of it at
+// least once a second. With MEXC_SHM=/name set they go to the shared memory
+// segment /name_<venue> (ShmRing.h); with Venue::FANOUT_ENV=group:port, to
+// the multicast fan-out (MulticastFanout.h). Each shard worker writes its own
+// ring and its own multicast channel.
+//
+// A diff stream that loses sequence needs a REST snapshot. The shard only
+// asks for it: the request runs on the io thread (Venue::snapshots) and its
+// body comes back through the shard's queue as a Snapshot message, which
+// rebuilds the book. Meanwhile the symbol's deltas are buffered and the
+// shard's other symbols carry on.
+//
+// Trades (deals frames) feed the symbol's OrderFlowTracker and VWAP. The flow
+// has its own seqlock, so a burst of trades does not republish the book.
+//
+// A symbol can also publish LADDER_ROWS price ticks around the mid, every
+// tick whether it holds a level or not, through a seqlock of its own. Only
+// symbols a reader asked for with setLadder() pay for it.
+//
+// The book also keeps coarser ladders of it, always current: price buckets
+// one grouping step wide. Steps are prices ("0.1,1,10" in
+// Venue::GROUPINGS_ENV, DEFAULT_GROUPING_STEPS without it) and become ticks
+// of each symbol's own scale once it is learned, and again when it widens;
+// a step that is not a whole number of ticks, or is a single tick, is left
+// out for that symbol. The one a reader selected with setGrouping() is
+// published through a third seqlock; switching only republishes it from the
+// buckets already there.
+//
+
+#ifndef VENUE_FEED_H
+#define VENUE_FEED_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/ssl/context.hpp>
+
+#include "BookSnapshot.h"
+#include "FixedPoint.h"
+#include "FrameJournal.h"
+#include "Indicators.h"
+#include "LatencyHistogram.h"
+#include "MarketFeed.h"
+#include "MulticastFanout.h"
+#include "ShardPool.h"
+#include "ShmRing.h"
+#include "SnapshotSource.h"
+#include "SubscriptionManager.h"
+
+template <typename Venue>
+class VenueFeed {
+public:
+    using Entry = typename Venue::Entry;
+    static constexpr size_t BOOK_DEPTH = 20;
+    static constexpr size_t MAX_SYMBOLS = 256;
+    using BookView = BookSnapshot<Entry, BOOK_DEPTH>;
+    using GroupedView = GroupedSnapshot<Entry, BOOK_DEPTH>;
+    // Twice the heatmap's 512 rows, so its window, which only recentres once
+    // the mid is a quarter of the way out, always lies inside
+    static constexpr size_t LADDER_ROWS = 1024;
+    using LadderView = LadderSnapshot<LADDER_ROWS>;
+
+    static constexpr const char* DEFAULT_GROUPING_STEPS = "0.01,0.1,1,10";
+
+    // One tracked symbol. Everything except the snapshots and the grouping
+    // belongs to the shard worker that owns the symbol; other threads only
+    // read the snapshots.
+    struct Symbol : FeedState {
+        uint32_t index = 0;
+        BookView staging;               // Filled by publish()
+        Seqlock<BookView> snapshot;     // Top of the book, published after every applied message
+        TrendTracker trend;             // Mid price indicators, fed on every book change
+        OrderFlowTracker flow;          // Taker flow, fed on every deals frame
+        Seqlock<OrderFlow> flowSnapshot; // Published after every deals frame and as the window moves
+        uint64_t publishedVersion = 0;  // book.trackedVersion() of the last publish
+        std::atomic<uint32_t> grouping{0}; // 1 + index into groupingSteps(), 0 for none; see setGrouping()
+        SymbolScale groupingScale;      // Scale the book's groupings were made for
+        std::vector<int> groupingOf;    // Book grouping of each step, -1 where the step does not fit
+        GroupedView groupedStaging;     // Filled by publishGrouped()
+        Seqlock<GroupedView> groupedSnapshot;
+        uint64_t groupedVersion = 0;    // book.version() of the last grouped publish
+        std::atomic<bool> ladder{false}; // Publish ladderSnapshot; see setLadder()
+        LadderView ladderStaging;       // Filled by publishLadder()
+        Seqlock<LadderView> ladderSnapshot;
+        uint64_t ladderVersion = 0;     // book.version() of the last ladder publish
+        SnapshotSource snapshots;       // Hands the fetched snapshot to a resync, or asks for one
+        std::string fetchedSnapshot;    // Delivered by a Snapshot message, taken by the next resync
+        bool snapshotFetched = false;
+        bool snapshotRequested = false; // A fetch is on its way; at most one per symbol
+
+        // Levels last sent out of the process, the base of the next delta
+        Entry sentBids[BOOK_DEPTH];
+        Entry sentAsks[BOOK_DEPTH];
+        uint32_t sentBidCount = 0;
+        uint32_t sentAskCount = 0;
+        SymbolScale sentScale;
+        int64_t sentSnapshotNs = 0;     // Last snapshot sent, 0: send one next
+    };
+
+    static constexpr int64_t RESYNC_INTERVAL_NS = 1'000'000'000;
+    // Records of one publish: a delta that replaced every level (a removal
+    // and an addition each), or a Clear and both full sides
+    static constexpr size_t MAX_UPDATE_RECORDS = 4 * BOOK_DEPTH + 1;
+
+    // incrementalDepth: diff streams kept in sync by version; false falls back
+    // to the venue's 20-level full depth streams
+    VenueFeed(boost::asio::io_context& ioc, boost::asio::ssl::context& ctx, size_t shardCount,
+              bool incrementalDepth = true)
+        : m_ioc(ioc),
+          m_snapshots(Venue::snapshots(ioc)),
+          m_shards(shardCount, [this](uint32_t index, ShardPool::Kind kind, std::string_view text, int64_t recvNs) {
+              onShardMessage(index, kind, text, recvNs);
+          }),
+          m_subscriptions(ioc, ctx, Venue::connection(incrementalDepth), m_shards, MAX_SYMBOLS,
+                          [this](uint32_t index, const std::string& symbol) {
+              m_feeds[index] = std::make_unique<Symbol>();
+              m_feeds[index]->index = index;
+              m_feeds[index]->symbol = symbol;
+              m_feeds[index]->snapshots = [this, feed = m_feeds[index].get()](const std::string&, std::string& body) {
+                  return takeSnapshot(*feed, body);
+              };
+              m_feeds[index]->book.setTrackedDepth(BOOK_DEPTH);
+              if (m_shm) m_shm->defineSymbol(index, symbol);
+          }) {
+        const char* steps = std::getenv(Venue::GROUPINGS_ENV);
+        setGroupingSteps(splitGroupingSteps(steps ? steps : DEFAULT_GROUPING_STEPS));
+    }
+
+    VenueFeed(const VenueFeed&) = delete;
+    VenueFeed& operator=(const VenueFeed&) = delete;
+
+    // Starts the workers on cores firstCore.., the journal under MEXC_JOURNAL
+    // (prefix Venue::NAME), the shared memory segment under MEXC_SHM, the
+    // fan-out under Venue::FANOUT_ENV and the symbols listed in
+    // Venue::SYMBOLS_ENV
+    void start(size_t firstCore) {
+        if (const char* name = std::getenv("MEXC_SHM")) {
+            m_shm = std::make_unique<ShmFeedWriter>(std::string(name) + "_" + Venue::NAME, Venue::NAME,
+                                                    m_shards.shardCount(), 65536, MAX_SYMBOLS);
+            if (!m_shm->open()) m_shm.reset();
+        }
+        MulticastFanout::Options fanout;
+        if (fanoutFromEnv(Venue::FANOUT_ENV, fanout)) {
+            m_fanout = std::make_unique<MulticastFanout>(m_ioc, Venue::NAME, m_shards.shardCount(), fanout,
+                [this](std::vector<BookSymbolName>& symbols, std::vector<BookRecord>& records) {
+                    recoverySnapshot(symbols, records);
+                });
+            if (!m_fanout->open()) m_fanout.reset();
+        }
+
+        m_shards.start(true, firstCore);
+
+        if (const char* directory = std::getenv("MEXC_JOURNAL")) {
+            m_journal = std::make_unique<FrameJournal>(
+                FrameJournal::Options{.directory = directory, .prefix = Venue::NAME, .tag = Venue::NAME});
+            if (m_journal->open()) m_subscriptions.setJournal(m_journal.get());
+        }
+
+        if (const char* list = std::getenv(Venue::SYMBOLS_ENV)) {
+            m_subscriptions.addList(list);
+        }
+    }
+
+    // Joins the workers once the io_context has returned
+    void stop() { m_shards.stop(); }
+
+    // Thread safe; done runs on the io thread with the symbol's index
+    void add(std::string symbol, SubscriptionManager::AddedHandler done = {}) {
+        m_subscriptions.add(std::move(symbol), std::move(done));
+    }
+    void add(std::string_view base, std::string_view quote, SubscriptionManager::AddedHandler done = {}) {
+        add(Venue::symbol(base, quote), std::move(done));
+    }
+
+    // Symbols placed so far; read on the io thread
+    size_t symbolCount() const { return m_subscriptions.symbolCount(); }
+    // Slot of an added symbol; the pointer stays valid for the life of the feed
+    Symbol* symbol(uint32_t index) const { return index < MAX_SYMBOLS ? m_feeds[index].get() : nullptr; }
+
+    // Price steps of the groupings, e.g. {"0.1", "1", "10"}. Only before
+    // start(); steps that are not positive decimals are left out.
+    void setGroupingSteps(const std::vector<std::string>& steps) {
+        m_groupingSteps.clear();
+        for (const std::string& step : steps) {
+            int64_t value;
+            if (parseFixed(step, FIXED_MAX_DECIMALS, value) && value > 0) {
+                m_groupingSteps.push_back(step);
+            } else {
+                std::cerr << Venue::NAME << ": ignoring grouping step '" << step << "'" << std::endl;
+            }
+        }
+    }
+    const std::vector<std::string>& groupingSteps() const { return m_groupingSteps; }
+
+    // Width of a grouping step in ticks of `scale`; 0 when it is not a whole
+    // number of ticks or is a single one
+    static int64_t stepTicks(const std::string& step, const SymbolScale& scale) {
+        int64_t ticks;
+        bool exact = true;
+        if (!scale.known() || !parseFixed(step, scale.priceDecimals, ticks, &exact) || !exact) return 0;
+        return ticks > 1 ? ticks : 0;
+    }
+
+    // Thread safe. Selects what the symbol's groupedSnapshot shows: 0 for
+    // nothing, g for groupingSteps()[g - 1]. The worker republishes it at once.
+    void setGrouping(Symbol& symbol, uint32_t grouping) {
+        symbol.grouping.store(std::min<uint32_t>(grouping, m_groupingSteps.size()), std::memory_order_relaxed);
+        // Only the io thread may post to the shards
+        boost::asio::post(m_ioc, [this, index = symbol.index] { m_shards.post(index, ShardPool::Kind::Refresh); });
+    }
+
+    // Thread safe. Turns the symbol's ladderSnapshot on or off; the worker
+    // publishes it at once and then after every book change.
+    void setLadder(Symbol& symbol, bool on) {
+        symbol.ladder.store(on, std::memory_order_relaxed);
+        boost::asio::post(m_ioc, [this, index = symbol.index] { m_shards.post(index, ShardPool::Kind::Refresh); });
+    }
+
+    LatencyStats& latency() { return m_latency; }
+    size_t shardCount() const { return m_shards.shardCount(); }
+
+private:
+    void onShardMessage(uint32_t index, ShardPool::Kind kind, std::string_view text, int64_t recvNs) {
+        Symbol& feed = *m_feeds[index];
+
+        if (kind == ShardPool::Kind::Reset) {
+            // The symbol's stream (re)started; the book is rebuilt from it
+            feed.reset();
+            feed.fetchedSnapshot.clear();
+            feed.snapshotFetched = false;
+            feed.sentSnapshotNs = 0;
+            updateGroupings(feed);
+            publish(index, feed);
+            publishGrouped(feed);
+            if (feed.ladder.load(std::memory_order_relaxed)) publishLadder(feed);
+            return;
+        }
+        if (kind == ShardPool::Kind::Refresh) {
+            publishGrouped(feed);
+            if (feed.ladder.load(std::memory_order_relaxed)) publishLadder(feed);
+            return;
+        }
+        if (kind == ShardPool::Kind::Snapshot) {
+            feed.snapshotRequested = false;
+            // A failed fetch was reported; the next delta asks again
+            if (text.empty() || feed.sequencer.live()) return;
+            feed.fetchedSnapshot.assign(text);
+            feed.snapshotFetched = true;
+            onResult(index, feed, Venue::resync(feed, feed.snapshots), text, recvNs);
+            return;
+        }
+
+        int64_t startNs = steadyNowNs();
+        FeedTiming timing;
+        FeedResult result = Venue::apply(feed, text, feed.snapshots, BOOK_DEPTH, &timing);
+        if (result != FeedResult::NotMarketData && recvNs) {
+            int64_t doneNs = steadyNowNs();
+            m_latency.record(LatencyStage::Queue, startNs - recvNs);
+            m_latency.record(LatencyStage::Parse, timing.parsedNs - startNs);
+            m_latency.record(LatencyStage::Apply, doneNs - timing.parsedNs);
+            if (timing.exchangeMs > 0) {
+                m_latency.record(LatencyStage::Network, steadyToSystemNs(recvNs) - timing.exchangeMs * 1000000);
+            }
+        }
+        onResult(index, feed, result, text, recvNs);
+    }
+
+    void onResult(uint32_t index, Symbol& feed, FeedResult result, std::string_view text, int64_t recvNs) {
+        if (!(feed.scale == feed.groupingScale)) updateGroupings(feed);
+
+        switch (result) {
+            case FeedResult::Updated:
+                // Book events keep the flow window moving while no one trades
+                if (feed.flow.advance(recvNs ? recvNs : steadyNowNs())) feed.flowSnapshot.publish(feed.flow.values());
+
+                // Buckets sum levels deeper than the shown ones, so any change may move them
+                if (feed.grouping.load(std::memory_order_relaxed) && feed.book.version() != feed.groupedVersion) {
+                    publishGrouped(feed);
+                }
+                if (feed.ladder.load(std::memory_order_relaxed) && feed.book.version() != feed.ladderVersion) {
+                    publishLadder(feed);
+                }
+
+                // Changes behind the shown levels leave the snapshot, and its readers, alone
+                if (feed.book.trackedVersion() == feed.publishedVersion) break;
+                if (feed.book.bestBid() != OrderBookEngine::NO_PRICE && feed.book.bestAsk() != OrderBookEngine::NO_PRICE) {
+                    double mid = fixedToDouble(feed.book.bestBid() + feed.book.bestAsk(), feed.scale.priceDecimals) / 2;
+                    feed.trend.onMid(recvNs ? recvNs : steadyNowNs(), mid);
+                }
+                publish(index, feed, recvNs);
+                break;
+            case FeedResult::Traded:
+                onTrades(feed, recvNs ? recvNs : steadyNowNs());
+                break;
+            case FeedResult::Unchanged:
+                break;
+            case FeedResult::NotMarketData:
+                Venue::other(text);
+                break;
+        }
+    }
+
+    // The symbol's SnapshotSource, on its shard: the snapshot a Snapshot
+    // message delivered, or false after asking the io thread to fetch one
+    bool takeSnapshot(Symbol& feed, std::string& body) {
+        if (feed.snapshotFetched) {
+            feed.snapshotFetched = false;
+            body.swap(feed.fetchedSnapshot);
+            return true;
+        }
+        if (feed.snapshotRequested) return false;
+        feed.snapshotRequested = true;
+        // Only the io thread may post to the shards, so the result goes back from there
+        boost::asio::post(m_ioc, [this, index = feed.index, symbol = feed.symbol] {
+            m_snapshots(symbol, [this, index](bool ok, std::string body) {
+                m_shards.post(index, ShardPool::Kind::Snapshot, ok ? std::string_view(body) : std::string_view());
+            });
+        });
+        return false;
+    }
+
+    // Folds the trades of one deals frame into the symbol's flow and VWAP.
+    // A frame is one sample however many trades it carries: its VWAP weighs
+    // in exactly as the trades would one by one.
+    static void onTrades(Symbol& feed, int64_t tNs) {
+        const TradeBatch& trades = feed.trades;
+        double buy = fixedToDouble(trades.buyQty, feed.scale.qtyDecimals);
+        double sell = fixedToDouble(trades.sellQty, feed.scale.qtyDecimals);
+        feed.flow.onTrades(tNs, buy, sell, trades.count);
+        feed.trend.onTrade(tNs, trades.notional / (buy + sell), buy + sell);
+        feed.flowSnapshot.publish(feed.flow.values());
+    }
+
+    // Publishes the visible top of the book to the other threads
+    void publish(uint32_t index, Symbol& feed, int64_t recvNs = 0) {
+        BookView& view = feed.staging;
+        view.version++;
+        view.recvNs = recvNs;
+        view.scale = feed.scale;
+        view.askCount = 0;
+        view.bidCount = 0;
+        feed.book.forEachLevel(Side::Ask, BOOK_DEPTH, [&view](int64_t price, int64_t qty, int32_t orders) {
+            view.asks[view.askCount++] = entryOf(price, qty, orders);
+        });
+        feed.book.forEachLevel(Side::Bid, BOOK_DEPTH, [&view](int64_t price, int64_t qty, int32_t orders) {
+            view.bids[view.bidCount++] = entryOf(price, qty, orders);
+        });
+
+        const DepthCurve& bidCurve = feed.book.depth(Side::Bid);
+        const DepthCurve& askCurve = feed.book.depth(Side::Ask);
+        std::copy_n(bidCurve.cumulative.data(), view.bidCount, view.bidDepth);
+        std::copy_n(askCurve.cumulative.data(), view.askCount, view.askDepth);
+        view.bidMaxVolume = bidCurve.maxQty;
+        view.askMaxVolume = askCurve.maxQty;
+        view.bidBookVolume = feed.book.totalQty(Side::Bid);
+        view.askBookVolume = feed.book.totalQty(Side::Ask);
+        view.trend = feed.trend.values();
+        feed.publishedVersion = feed.book.trackedVersion();
+        feed.snapshot.publish(view);
+        if (!m_shm && !m_fanout) return;
+
+        BookRecord records[MAX_UPDATE_RECORDS];
+        size_t count = encodeUpdate(index, feed, view, records);
+        size_t channel = m_shards.shardOf(index);
+        if (m_shm) {
+            for (size_t i = 0; i < count; i++) m_shm->write(channel, records[i]);
+        }
+        if (m_fanout) m_fanout->send(channel, records, count);
+    }
+
+    // Gives the book a grouping for each step that fits the symbol's scale,
+    // or none while the scale is unknown
+    void updateGroupings(Symbol& feed) {
+        std::vector<int64_t> ticks;
+        feed.groupingScale = feed.scale;
+        feed.groupingOf.assign(m_groupingSteps.size(), -1);
+        for (size_t i = 0; i < m_groupingSteps.size(); i++) {
+            int64_t width = stepTicks(m_groupingSteps[i], feed.scale);
+            if (!width) continue;
+            feed.groupingOf[i] = static_cast<int>(ticks.size());
+            ticks.push_back(width);
+        }
+        feed.book.setGroupings(ticks);
+        publishGrouped(feed);
+    }
+
+    // "0.1, 1,10" -> {"0.1", "1", "10"}
+    static std::vector<std::string> splitGroupingSteps(std::string_view list) {
+        std::vector<std::string> steps;
+        while (!list.empty()) {
+            size_t comma = list.find(',');
+            std::string_view step = list.substr(0, comma);
+            while (!step.empty() && step.front() == ' ') step.remove_prefix(1);
+            while (!step.empty() && step.back() == ' ') step.remove_suffix(1);
+            if (!step.empty()) steps.emplace_back(step);
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+        }
+        return steps;
+    }
+
+    // Publishes the top buckets of the selected grouping, or an empty view
+    // when none is selected or its step does not fit the scale
+    static void publishGrouped(Symbol& feed) {
+        GroupedView& view = feed.groupedStaging;
+        uint32_t selected = feed.grouping.load(std::memory_order_relaxed);
+        int grouping = selected && selected <= feed.groupingOf.size() ? feed.groupingOf[selected - 1] : -1;
+        view.version++;
+        view.grouping = selected;
+        view.groupTicks = grouping >= 0 ? feed.book.groupingTicks(grouping) : 0;
+        view.scale = feed.scale;
+        view.bidCount = 0;
+        view.askCount = 0;
+        view.bidMaxVolume = 0;
+        view.askMaxVolume = 0;
+        if (grouping >= 0) {
+            feed.book.forEachGroupedLevel(grouping, Side::Bid, BOOK_DEPTH,
+                                          [&view](int64_t price, int64_t qty, int32_t orders) {
+                view.bids[view.bidCount++] = entryOf(price, qty, orders);
+                view.bidMaxVolume = std::max(view.bidMaxVolume, qty);
+            });
+            feed.book.forEachGroupedLevel(grouping, Side::Ask, BOOK_DEPTH,
+                                          [&view](int64_t price, int64_t qty, int32_t orders) {
+                view.asks[view.askCount++] = entryOf(price, qty, orders);
+                view.askMaxVolume = std::max(view.askMaxVolume, qty);
+            });
+        }
+        feed.groupedVersion = feed.book.version();
+        feed.groupedSnapshot.publish(view);
+    }
+
+    // Publishes LADDER_ROWS ticks centred on the mid, read straight from the
+    // book's slots
+    static void publishLadder(Symbol& feed) {
+        LadderView& view = feed.ladderStaging;
+        const OrderBookEngine& book = feed.book;
+        view.version++;
+        view.scale = feed.scale;
+        view.filled = book.bestBid() != OrderBookEngine::NO_PRICE && book.bestAsk() != OrderBookEngine::NO_PRICE;
+        if (view.filled) {
+            view.bestBid = book.bestBid();
+            view.bestAsk = book.bestAsk();
+            view.topTick = (view.bestBid + view.bestAsk) / 2 + static_cast<int64_t>(LADDER_ROWS / 2);
+            for (size_t row = 0; row < LADDER_ROWS; row++) {
+                int64_t price = view.topTick - static_cast<int64_t>(row);
+                view.qty[row] = price <= view.bestBid ? book.qtyAt(Side::Bid, price)
+                              : price >= view.bestAsk ? book.qtyAt(Side::Ask, price) : 0;
+            }
+        }
+        feed.ladderVersion = book.version();
+        feed.ladderSnapshot.publish(view);
+    }
+
+    // Encodes the levels of `view` that differ from the last update sent, or
+    // all of them after a Clear when a snapshot is due. Returns the count.
+    static size_t encodeUpdate(uint32_t index, Symbol& feed, const BookView& view, BookRecord* out) {
+        BookRecord base = recordOf(index, view);
+        const int64_t nowNs = base.publishNs;
+        bool snapshot = feed.sentSnapshotNs == 0 || nowNs - feed.sentSnapshotNs >= RESYNC_INTERVAL_NS ||
+                        view.scale.priceDecimals != feed.sentScale.priceDecimals ||
+                        view.scale.qtyDecimals != feed.sentScale.qtyDecimals;
+
+        size_t count = 0;
+        if (snapshot) {
+            count = encodeSnapshot(base, view, out);
+            feed.sentSnapshotNs = nowNs;
+            feed.sentScale = view.scale;
+        } else {
+            auto level = [&](uint8_t side, int64_t price, int64_t qty, int32_t orders) {
+                out[count++] = levelOf(base, side, price, qty, orders);
+            };
+            diffLevels(0, feed.sentBids, feed.sentBidCount, view.bids, view.bidCount, level);
+            diffLevels(1, feed.sentAsks, feed.sentAskCount, view.asks, view.askCount, level);
+            if (count) out[count - 1].flags |= BOOK_END_OF_UPDATE;
+        }
+
+        std::copy_n(view.bids, view.bidCount, feed.sentBids);
+        std::copy_n(view.asks, view.askCount, feed.sentAsks);
+        feed.sentBidCount = view.bidCount;
+        feed.sentAskCount = view.askCount;
+        return count;
+    }
+
+    // A Clear and every level of `view`, the last flagged end-of-update
+    static size_t encodeSnapshot(const BookRecord& base, const BookView& view, BookRecord* out) {
+        size_t count = 0;
+        out[count] = base;
+        out[count++].type = BookRecordType::Clear;
+        for (uint32_t i = 0; i < view.bidCount; i++) {
+            out[count++] = levelOf(base, 0, view.bids[i].price, view.bids[i].volume, ordersOf(view.bids[i]));
+        }
+        for (uint32_t i = 0; i < view.askCount; i++) {
+            out[count++] = levelOf(base, 1, view.asks[i].price, view.asks[i].volume, ordersOf(view.asks[i]));
+        }
+        out[count - 1].flags |= BOOK_END_OF_UPDATE;
+        return count;
+    }
+
+    // Every published book as a snapshot, for a fan-out subscriber that lost
+    // datagrams. Runs on the io thread, which owns the symbol table.
+    void recoverySnapshot(std::vector<BookSymbolName>& symbols, std::vector<BookRecord>& records) const {
+        BookView view;
+        BookRecord snapshot[MAX_UPDATE_RECORDS];
+        size_t count = symbolCount();
+        symbols.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            const Symbol& feed = *m_feeds[i];
+            std::strncpy(symbols[i].name, feed.symbol.c_str(), sizeof(symbols[i].name) - 1);
+            symbols[i].name[sizeof(symbols[i].name) - 1] = '\0';
+            feed.snapshot.read(view);
+            if (!view.scale.known()) continue;
+            size_t n = encodeSnapshot(recordOf(i, view), view, snapshot);
+            records.insert(records.end(), snapshot, snapshot + n);
+        }
+    }
+
+    static BookRecord recordOf(uint32_t index, const BookView& view) {
+        BookRecord record = {};
+        record.type = BookRecordType::Level;
+        record.symbol = index;
+        record.priceDecimals = static_cast<int8_t>(view.scale.priceDecimals);
+        record.qtyDecimals = static_cast<int8_t>(view.scale.qtyDecimals);
+        record.version = view.version;
+        record.recvNs = view.recvNs;
+        record.publishNs = steadyNowNs();
+        return record;
+    }
+
+    static BookRecord levelOf(const BookRecord& base, uint8_t side, int64_t price, int64_t qty, int32_t orders) {
+        BookRecord record = base;
+        record.side = side;
+        record.price = price;
+        record.qty = qty;
+        record.orders = orders;
+        return record;
+    }
+
+    // Merges two price-ordered level lists (bids descending, asks ascending)
+    // and reports each level that appeared, changed or went away (qty 0)
+    template <typename Level>
+    static void diffLevels(uint8_t side, const Entry* before, uint32_t beforeCount, const Entry* after,
+                           uint32_t afterCount, Level&& level) {
+        auto ahead = [side](int64_t a, int64_t b) { return side == 0 ? a > b : a < b; };
+        uint32_t i = 0, j = 0;
+        while (i < beforeCount || j < afterCount) {
+            if (j == afterCount || (i < beforeCount && ahead(before[i].price, after[j].price))) {
+                level(side, before[i].price, 0, 0);
+                i++;
+            } else if (i == beforeCount || ahead(after[j].price, before[i].price)) {
+                level(side, after[j].price, after[j].volume, ordersOf(after[j]));
+                j++;
+            } else {
+                if (before[i].volume != after[j].volume || ordersOf(before[i]) != ordersOf(after[j])) {
+                    level(side, after[j].price, after[j].volume, ordersOf(after[j]));
+                }
+                i++;
+                j++;
+            }
+        }
+    }
+
+    static Entry entryOf(int64_t price, int64_t qty, int32_t orders) {
+        if constexpr (Venue::HAS_ORDERS) {
+            return {price, qty, orders};
+        } else {
+            return {price, qty};
+        }
+    }
+
+    static int32_t ordersOf(const Entry& entry) {
+        if constexpr (Venue::HAS_ORDERS) {
+            return entry.orders;
+        } else {
+            return 0;
+        }
+    }
+
+    // Slots are filled on the io thread before any frame of the symbol
+    // reaches a shard, and never freed
+    std::unique_ptr<Symbol> m_feeds[MAX_SYMBOLS];
+    boost::asio::io_context& m_ioc;
+    AsyncSnapshotSource m_snapshots;   // Runs on the io thread
+    std::vector<std::string> m_groupingSteps;   // Fixed once the workers run
+    LatencyStats m_latency;     // Per-stage latency of every applied frame
+    std::unique_ptr<FrameJournal> m_journal;
+    std::unique_ptr<ShmFeedWriter> m_shm;
+    std::unique_ptr<MulticastFanout> m_fanout;
+    ShardPool m_shards;
+    SubscriptionManager m_subscriptions;
+};
+
+#endif //VENUE_FEED_H
@@ -0,0 +1,220 @@
+#include "WebSocketSession.h"
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace beast = boost::beast;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = net::ip::tcp;
+
+WebSocketSession::WebSocketSession(net::io_context& ioc, ssl::context& ctx, Options options,
+                                   OpenHandler onOpen, MessageHandler onMessage)
+    : m_ioc(ioc),
+      m_ctx(ctx),
+      m_options(std::move(options)),
+      m_onOpen(std::move(onOpen)),
+      m_onMessage(std::move(onMessage)),
+      m_wake(ioc),
+      m_keepAlive(ioc) {}
+
+void WebSocketSession::start() {
+    net::co_spawn(m_ioc, run(), net::detached);
+}
+
+void WebSocketSession::send(std::string frame) {
+    net::post(m_ioc, [this, frame = std::move(frame)]() mutable {
+        queueWrite(std::move(frame));
+    });
+}
+
+void WebSocketSession::restart() {
+    net::post(m_ioc, [this] {
+        m_restart = true;
+        m_wake.cancel();
+        closeCurrent(true);
+    });
+}
+
+void WebSocketSession::stop() {
+    net::post(m_ioc, [this] {
+        m_stopped = true;
+        m_wake.cancel();
+        closeCurrent(true);
+    });
+}
+
+void WebSocketSession::queueWrite(std::string frame) {
+    if (!m_openStream) return;
+    m_outbox.push_back(std::move(frame));
+    if (!m_writing) {
+        m_writing = true;
+        net::co_spawn(m_ioc, writeOutbox(m_openStream), net::detached);
+    }
+}
+
+// The only writer of a connection, so data frames and pings never overlap
+net::awaitable<void> WebSocketSession::writeOutbox(std::shared_ptr<Stream> ws) {
+    while (m_openStream == ws && !m_outbox.empty()) {
+        beast::error_code ec;
+        co_await ws->async_write(net::buffer(m_outbox.front()), net::redirect_error(net::use_awaitable, ec));
+        if (ec || m_openStream != ws) break;  // The read fails too and the session reconnects
+        m_outbox.pop_front();
+    }
+    if (m_openStream == ws) m_writing = false;
+}
+
+void WebSocketSession::closeCurrent(bool graceful) {
+    if (!m_stream) return;
+
+    // Forgetting the stream keeps a second restart/timeout from closing it again
+    std::shared_ptr<Stream> ws = std::move(m_stream);
+    if (!graceful || !ws->is_open()) {
+        // Aborts whatever is pending on the socket, including a connect
+        beast::get_lowest_layer(*ws).close();
+        return;
+    }
+
+    // Send a close frame; the pending read then finishes with error::closed.
+    // The deadline covers a peer that never answers the close.
+    beast::get_lowest_layer(*ws).expires_after(std::chrono::seconds(2));
+    ws->async_close(websocket::close_code::normal, [ws](beast::error_code) {
+        beast::get_lowest_layer(*ws).close();
+    });
+}
+
+net::awaitable<void> WebSocketSession::run() {
+    while (!m_stopped) {
+        m_restart = false;
+        try {
+            co_await session();
+        } catch (const beast::system_error& e) {
+            if (e.code() == websocket::error::closed) {
+                std::cout << "WebSocket closed normally" << std::endl;
+            } else if (e.code() != net::error::operation_aborted) {
+                std::cerr << "WebSocket error: " << e.what() << std::endl;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Connection error: " << e.what() << std::endl;
+        }
+
+        m_stream.reset();
+        m_openStream.reset();
+        m_outbox.clear();
+        m_writing = false;
+        m_keepAlive.cancel();
+
+        if (m_stopped || m_restart) continue;
+        beast::error_code ec;
+        m_wake.expires_after(m_options.reconnectDelay);
+        co_await m_wake.async_wait(net::redirect_error(net::use_awaitable, ec));
+    }
+}
+
+net::awaitable<void> WebSocketSession::session() {
+    auto ws = std::make_shared<Stream>(m_ioc, m_ctx);
+    m_stream = ws;
+
+    tcp::resolver resolver(m_ioc);
+    auto const results = co_await resolver.async_resolve(m_options.host, m_options.port, net::use_awaitable);
+
+    beast::get_lowest_layer(*ws).expires_after(m_options.connectTimeout);
+    co_await beast::get_lowest_layer(*ws).async_connect(results, net::use_awaitable);
+
+    if (!SSL_set_tlsext_host_name(ws->next_layer().native_handle(), m_options.host.c_str())) {
+        throw beast::system_error(
+            beast::error_code(
+                static_cast<int>(::ERR_get_error()),
+                net::error::get_ssl_category()
+            )
+        );
+    }
+    co_await ws->next_layer().async_handshake(ssl::stream_base::client, net::use_awaitable);
+
+    // From here the websocket layer and keepAlive() own the timeouts
+    beast::get_lowest_layer(*ws).expires_never();
+    websocket::stream_base::timeout timeouts{};
+    timeouts.handshake_timeout = m_options.connectTimeout;
+    timeouts.idle_timeout = websocket::stream_base::none();
+    timeouts.keep_alive_pings = false;
+    ws->set_option(timeouts);
+
+    co_await ws->async_handshake(m_options.host, m_options.target, net::use_awaitable);
+    m_connects++;
+    std::cout << "Successfully connected to wss://" << m_options.host << m_options.target << std::endl;
+
+    // Anything send() queues from here on goes out after the subscriptions
+    m_openStream = ws;
+    for (std::string& frame : m_onOpen()) {
+        queueWrite(std::move(frame));
+    }
+
+    m_lastMessage = Clock::now();
+    net::co_spawn(m_ioc, keepAlive(ws), net::detached);
+
+    m_buffer.clear();
+    for (;;) {
+        co_await ws->async_read(m_buffer, net::use_awaitable);
+        m_lastMessage = Clock::now();
+        m_onMessage(std::string_view(static_cast<const char*>(m_buffer.data().data()), m_buffer.size()));
+        m_buffer.consume(m_buffer.size());
+    }
+}
+
+net::awaitable<void> WebSocketSession::keepAlive(std::shared_ptr<Stream> ws) {
+    bool pings = !m_options.pingMessage.empty();
+    Clock::time_point nextPing = Clock::now() + m_options.pingInterval;
+
+    // Ends as soon as the connection it was started for is replaced
+    while (m_stream == ws) {
+        Clock::time_point idleDeadline = m_lastMessage + m_options.idleTimeout;
+        m_keepAlive.expires_at(pings ? std::min(nextPing, idleDeadline) : idleDeadline);
+
+        beast::error_code ec;
+        co_await m_keepAlive.async_wait(net::redirect_error(net::use_awaitable, ec));
+        if (m_stream != ws) break;
+
+        Clock::time_point now = Clock::now();
+        if (now >= m_lastMessage + m_options.idleTimeout) {
+            std::cerr << "Connection timeout" << std::endl;
+            m_timeouts++;
+            closeCurrent(false);  // A silent peer will not answer a close frame either
+            break;
+        }
+        if (pings && now >= nextPing) {
+            nextPing = now + m_options.pingInterval;
+            queueWrite(m_options.pingMessage);
+        }
+    }
+}
+
+WebSocketSession::Options endpointFromEnv(const char* envVar, WebSocketSession::Options options) {
+    const char* url = std::getenv(envVar);
+    if (url == nullptr || *url == '\0') return options;
+
+    std::string spec = url;
+    if (spec.rfind("wss://", 0) != 0) {
+        std::cerr << envVar << ": unsupported endpoint '" << spec << "', expected wss://host[:port][/target]" << std::endl;
+        return options;
+    }
+
+    std::string rest = spec.substr(6);
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    size_t colon = authority.find(':');
+    options.host = authority.substr(0, colon);
+    options.port = colon == std::string::npos ? "443" : authority.substr(colon + 1);
+    if (slash != std::string::npos) options.target = rest.substr(slash);
+    std::cout << "Using endpoint wss://" << options.host << ":" << options.port << options.target << std::endl;
+    return options;
+}
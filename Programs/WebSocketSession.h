@@ -0,0 +1,106 @@
+//
+// Asynchronous WebSocket client built on C++20 coroutines.
+//
+// A session connects, sends its subscription frames and then reads frames
+// with co_await until the connection fails, goes silent for longer than the
+// idle timeout, or is restarted; after that it reconnects on its own. Pings
+// and the idle check run on a steady timer next to the read instead of in
+// between reads, so a silent socket is noticed on time. Nothing blocks, so
+// one thread running the io_context can drive any number of sessions.
+//
+// All handlers run on the io_context thread. send(), restart() and stop()
+// may be called from any thread.
+//
+
+#ifndef WEBSOCKET_SESSION_H
+#define WEBSOCKET_SESSION_H
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/ssl/context.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <deque>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class WebSocketSession {
+public:
+    using Stream = boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string host;
+        std::string port = "443";
+        std::string target = "/";
+        std::string pingMessage;                        // Empty: no application pings
+        Clock::duration connectTimeout = std::chrono::seconds(10);
+        Clock::duration pingInterval = std::chrono::seconds(15);
+        Clock::duration idleTimeout = std::chrono::seconds(30);
+        Clock::duration reconnectDelay = std::chrono::seconds(1);
+    };
+
+    // Called once every (re)connection's handshake is done. Resets the
+    // caller's state and returns the frames to send first.
+    using OpenHandler = std::function<std::vector<std::string>()>;
+    // Called for every frame; the text is only valid during the call
+    using MessageHandler = std::function<void(std::string_view text)>;
+
+    WebSocketSession(boost::asio::io_context& ioc, boost::asio::ssl::context& ctx, Options options,
+                     OpenHandler onOpen, MessageHandler onMessage);
+
+    // Spawns the connect/read/reconnect loop on the io_context
+    void start();
+    // Queues a frame behind anything already being written. Frames sent
+    // while disconnected are dropped; onOpen restores the subscriptions.
+    void send(std::string frame);
+    // Closes the current connection and reconnects straight away
+    void restart();
+    // Closes the current connection and stops reconnecting
+    void stop();
+
+    uint64_t connectCount() const { return m_connects; }
+    uint64_t timeoutCount() const { return m_timeouts; }
+
+private:
+    boost::asio::awaitable<void> run();
+    boost::asio::awaitable<void> session();
+    boost::asio::awaitable<void> keepAlive(std::shared_ptr<Stream> ws);
+    boost::asio::awaitable<void> writeOutbox(std::shared_ptr<Stream> ws);
+    void queueWrite(std::string frame);
+    void closeCurrent(bool graceful);
+
+    boost::asio::io_context& m_ioc;
+    boost::asio::ssl::context& m_ctx;
+    Options m_options;
+    OpenHandler m_onOpen;
+    MessageHandler m_onMessage;
+
+    // Only touched on the io_context thread
+    std::shared_ptr<Stream> m_stream;       // Current connection, null while reconnecting
+    boost::asio::steady_timer m_wake;       // Reconnect delay; cancelled by restart()
+    boost::asio::steady_timer m_keepAlive;  // Ping / idle deadline of the current connection
+    boost::beast::flat_buffer m_buffer;
+    std::shared_ptr<Stream> m_openStream;   // Set once the handshake is done; frames may be queued
+    std::deque<std::string> m_outbox;       // Frames waiting for the single writer
+    bool m_writing = false;
+    Clock::time_point m_lastMessage;
+    bool m_stopped = false;
+    bool m_restart = false;
+    uint64_t m_connects = 0;
+    uint64_t m_timeouts = 0;
+};
+
+// Points the options at "wss://host[:port][/target]" read from envVar, e.g.
+// a local mock server. Returns them unchanged when the variable is unset or
+// not a wss:// URL.
+WebSocketSession::Options endpointFromEnv(const char* envVar, WebSocketSession::Options options);
+
+#endif //WEBSOCKET_SESSION_H
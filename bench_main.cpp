@@ -0,0 +1,386 @@
+//
+// Microbenchmarks for the feed and the statistics behind the windows.
+//
+//   bench [--fixtures <dir>] [--filter <text>]
+//   bench --write-fixtures <dir>
+//
+// Inputs are read from resources/bench so every run, on every machine and
+// commit, measures the same frames and books. --write-fixtures regenerates
+// them; SyntheticBook is seeded, so the files come out identical.
+//
+// Each benchmark is timed in several samples of about 100 ms after a warm-up;
+// the best and median time per item are reported.
+//
+
+#include "Programs/BookMetrics.h"
+#include "Programs/Indicators.h"
+#include "Programs/MarketFeed.h"
+#include "Programs/MexcParser.h"
+#include "Programs/SyntheticMarket.h"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef BENCH_FIXTURE_DIR
+#define BENCH_FIXTURE_DIR "resources/bench"
+#endif
+
+namespace fs = std::filesystem;
+
+constexpr size_t BOOK_DEPTH = 20;           // Levels the windows show
+constexpr size_t SNAPSHOT_LEVELS = 1000;
+constexpr size_t STREAM_FRAMES = 2000;
+
+struct BenchEntry {
+    int64_t price;
+    int64_t volume;
+};
+
+using BenchBook = BookSnapshot<BenchEntry, BOOK_DEPTH>;
+
+// Keeps the compiler from discarding a result
+template <typename T>
+inline void keep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+static std::string g_filter;
+
+// fn runs one iteration covering `items` items
+template <typename Fn>
+static void benchmark(const char* name, size_t items, Fn&& fn) {
+    if (!g_filter.empty() && std::string_view(name).find(g_filter) == std::string_view::npos) return;
+
+    using Clock = std::chrono::steady_clock;
+    auto timeIterations = [&fn](size_t iterations) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; i++) fn();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    };
+
+    // Warm up and size a sample to roughly 100 ms
+    size_t iterations = 1;
+    while (timeIterations(iterations) < 1e7 && iterations < (size_t(1) << 30)) iterations *= 2;
+    iterations = std::max<size_t>(1, static_cast<size_t>(iterations * 1e8 / std::max(1.0, timeIterations(iterations))));
+
+    constexpr int SAMPLES = 7;
+    double perItem[SAMPLES];
+    for (int s = 0; s < SAMPLES; s++) {
+        perItem[s] = timeIterations(iterations) / static_cast<double>(iterations * items);
+    }
+    std::sort(perItem, perItem + SAMPLES);
+    printf("%-40s %10.1f ns/item  (median %8.1f)  %12.0f items/s\n",
+           name, perItem[0], perItem[SAMPLES / 2], 1e9 / perItem[SAMPLES / 2]);
+}
+
+static bool readFile(const fs::path& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Missing fixture " << path << " (run bench --write-fixtures <dir>)" << std::endl;
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// One frame per line
+static std::vector<std::string_view> splitLines(const std::string& text) {
+    std::vector<std::string_view> lines;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        if (end > start) lines.emplace_back(text.data() + start, end - start);
+        start = end + 1;
+    }
+    return lines;
+}
+
+static bool writeFile(const fs::path& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+    std::cout << "Wrote " << path << " (" << text.size() << " bytes)" << std::endl;
+    return true;
+}
+
+static int writeFixtures(const fs::path& dir) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    constexpr int64_t TIME_MS = 1735689600000;  // Fixed so the files never change
+
+    SyntheticBook spot("ETHUSDT", {.priceDecimals = 2, .qtyDecimals = 4, .startPrice = 335012,
+                                   .levels = SNAPSHOT_LEVELS, .churn = 6, .seed = 7});
+    SyntheticBook futures("BTC_USDT", {.priceDecimals = 1, .qtyDecimals = 0, .startPrice = 9701234,
+                                       .levels = SNAPSHOT_LEVELS, .churn = 6, .seed = 11});
+
+    bool ok = writeFile(dir / "spot_depth_snapshot.json", spotDepthSnapshot(spot, SNAPSHOT_LEVELS)) &&
+              writeFile(dir / "futures_depth_snapshot.json", futuresDepthSnapshot(futures, SNAPSHOT_LEVELS, TIME_MS));
+
+    std::string spotStream;
+    std::string futuresStream;
+    for (size_t i = 0; i < STREAM_FRAMES; i++) {
+        int64_t timeMs = TIME_MS + static_cast<int64_t>(i) * 10;
+        spotStream += spotDepthDeltaFrame(spot, spot.step(), timeMs) + '\n';
+        futuresStream += futuresDepthDeltaFrame(futures, futures.step(), timeMs) + '\n';
+    }
+    ok = ok && writeFile(dir / "spot_depth_stream.jsonl", spotStream) &&
+         writeFile(dir / "futures_depth_stream.jsonl", futuresStream);
+
+    // Single frames of every pushed message type
+    ok = ok && writeFile(dir / "spot_depth_delta.json", spotDepthDeltaFrame(spot, spot.step(), TIME_MS)) &&
+         writeFile(dir / "spot_limit_depth.json", spotLimitDepthFrame(spot, BOOK_DEPTH, TIME_MS)) &&
+         writeFile(dir / "spot_book_ticker.json", spotBookTickerFrame(spot, TIME_MS)) &&
+         writeFile(dir / "futures_depth.json", futuresDepthDeltaFrame(futures, futures.step(), TIME_MS)) &&
+         writeFile(dir / "futures_depth_full.json", futuresDepthFullFrame(futures, BOOK_DEPTH, TIME_MS));
+
+    // Deals frames from the next steps that printed a few trades
+    while (spot.trades().size() < 3) spot.step();
+    while (futures.trades().size() < 3) futures.step();
+    ok = ok && writeFile(dir / "spot_deals.json", spotDealsFrame(spot, TIME_MS)) &&
+         writeFile(dir / "futures_deal.json", futuresDealFrame(futures, TIME_MS));
+    return ok ? 0 : 1;
+}
+
+// A book fed from a fixture snapshot and its delta stream
+struct StreamFixture {
+    std::string snapshot;
+    std::string streamText;
+    std::vector<std::string_view> frames;
+    SnapshotSource snapshots;
+
+    bool load(const fs::path& dir, const char* snapshotFile, const char* streamFile) {
+        if (!readFile(dir / snapshotFile, snapshot) || !readFile(dir / streamFile, streamText)) return false;
+        frames = splitLines(streamText);
+        snapshots = [this](const std::string&, std::string& body) {
+            body = snapshot;
+            return true;
+        };
+        return true;
+    }
+};
+
+static void startFeed(FeedState& feed) {
+    feed.reset();
+    feed.lastResync = {};   // Let the first delta fetch the snapshot straight away
+}
+
+int main(int argc, char** argv) {
+    fs::path dir = BENCH_FIXTURE_DIR;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--write-fixtures" && i + 1 < argc) return writeFixtures(argv[++i]);
+        if (arg == "--fixtures" && i + 1 < argc) dir = argv[++i];
+        else if (arg == "--filter" && i + 1 < argc) g_filter = argv[++i];
+        else {
+            std::cerr << "Usage: bench [--fixtures <dir>] [--filter <text>] | --write-fixtures <dir>" << std::endl;
+            return 1;
+        }
+    }
+
+    std::string spotDelta, spotLimit, spotTicker, spotDeals, futuresDelta, futuresFull, futuresDeal;
+    StreamFixture spotStream, futuresStream;
+    if (!readFile(dir / "spot_depth_delta.json", spotDelta) ||
+        !readFile(dir / "spot_limit_depth.json", spotLimit) ||
+        !readFile(dir / "spot_book_ticker.json", spotTicker) ||
+        !readFile(dir / "spot_deals.json", spotDeals) ||
+        !readFile(dir / "futures_depth.json", futuresDelta) ||
+        !readFile(dir / "futures_depth_full.json", futuresFull) ||
+        !readFile(dir / "futures_deal.json", futuresDeal) ||
+        !spotStream.load(dir, "spot_depth_snapshot.json", "spot_depth_stream.jsonl") ||
+        !futuresStream.load(dir, "futures_depth_snapshot.json", "futures_depth_stream.jsonl")) {
+        return 1;
+    }
+
+    // JSON parse: the on-demand parser, with nlohmann for reference
+    MexcMessage msg;
+    benchmark("parse/spot_depth_delta", 1, [&] { keep(parseSpotMessage(spotDelta, msg)); });
+    benchmark("parse/spot_limit_depth", 1, [&] { keep(parseSpotMessage(spotLimit, msg)); });
+    benchmark("parse/spot_book_ticker", 1, [&] { keep(parseSpotMessage(spotTicker, msg)); });
+    benchmark("parse/futures_depth", 1, [&] { keep(parseFuturesMessage(futuresDelta, msg)); });
+    benchmark("parse/futures_depth_full", 1, [&] { keep(parseFuturesMessage(futuresFull, msg)); });
+    benchmark("parse/spot_deals", 1, [&] { keep(parseSpotMessage(spotDeals, msg)); });
+    benchmark("parse/futures_deal", 1, [&] { keep(parseFuturesMessage(futuresDeal, msg)); });
+    benchmark("parse/spot_limit_depth_nlohmann", 1, [&] {
+        nlohmann::json j = nlohmann::json::parse(spotLimit);
+        keep(j.size());
+    });
+    benchmark("parse/futures_depth_full_nlohmann", 1, [&] {
+        nlohmann::json j = nlohmann::json::parse(futuresFull);
+        keep(j.size());
+    });
+
+    // Level apply: parsed levels into the engine, one pass over the stream
+    // from the snapshot per iteration
+    {
+        std::vector<MexcMessage> parsed(spotStream.frames.size());
+        for (size_t i = 0; i < parsed.size(); i++) parseSpotMessage(spotStream.frames[i], parsed[i]);
+        MexcMessage snapshot;
+        parseSpotSnapshot(spotStream.snapshot, snapshot);
+        SymbolScale scale;
+        learnScale(scale, snapshot.asks);
+        learnScale(scale, snapshot.bids);
+
+        OrderBookEngine book;
+        benchmark("apply/spot_levels", parsed.size(), [&] {
+            book.clear();
+            applyLevels(book, Side::Ask, snapshot.asks, scale);
+            applyLevels(book, Side::Bid, snapshot.bids, scale);
+            for (const MexcMessage& delta : parsed) {
+                applyLevels(book, Side::Ask, delta.asks, scale);
+                applyLevels(book, Side::Bid, delta.bids, scale);
+            }
+            keep(book.bestBid());
+        });
+    }
+
+    // The whole feed path: parse, sequence and apply every frame
+    FeedState spotFeed;
+    spotFeed.symbol = "ETHUSDT";
+    benchmark("feed/spot_depth_stream", spotStream.frames.size(), [&] {
+        startFeed(spotFeed);
+        for (std::string_view frame : spotStream.frames) {
+            keep(applySpotFrame(spotFeed, frame, spotStream.snapshots, BOOK_DEPTH));
+        }
+    });
+    FeedState futuresFeed;
+    futuresFeed.symbol = "BTC_USDT";
+    benchmark("feed/futures_depth_stream", futuresStream.frames.size(), [&] {
+        startFeed(futuresFeed);
+        for (std::string_view frame : futuresStream.frames) {
+            keep(applyFuturesFrame(futuresFeed, frame, futuresStream.snapshots));
+        }
+    });
+
+    // The same stream with the engine keeping the window's depth aggregates
+    FeedState trackedFeed;
+    trackedFeed.symbol = "ETHUSDT";
+    trackedFeed.book.setTrackedDepth(BOOK_DEPTH);
+    benchmark("feed/spot_depth_stream_tracked", spotStream.frames.size(), [&] {
+        startFeed(trackedFeed);
+        for (std::string_view frame : spotStream.frames) {
+            keep(applySpotFrame(trackedFeed, frame, spotStream.snapshots, BOOK_DEPTH));
+            keep(trackedFeed.book.depth(Side::Bid).maxQty);
+            keep(trackedFeed.book.depth(Side::Ask).maxQty);
+        }
+    });
+
+    // The same stream with three groupings summed on every level change
+    FeedState groupedFeed;
+    groupedFeed.symbol = "ETHUSDT";
+    groupedFeed.book.setTrackedDepth(BOOK_DEPTH);
+    groupedFeed.book.setGroupings({10, 100, 1000});
+    benchmark("feed/spot_depth_stream_grouped", spotStream.frames.size(), [&] {
+        startFeed(groupedFeed);
+        for (std::string_view frame : spotStream.frames) {
+            keep(applySpotFrame(groupedFeed, frame, spotStream.snapshots, BOOK_DEPTH));
+        }
+    });
+    // Both sides of the top 20 buckets of 10 ticks, as published to the window
+    startFeed(groupedFeed);
+    for (std::string_view frame : spotStream.frames) applySpotFrame(groupedFeed, frame, spotStream.snapshots, BOOK_DEPTH);
+    benchmark("engine/forEachGroupedLevel", 2, [&] {
+        for (Side side : {Side::Bid, Side::Ask}) {
+            groupedFeed.book.forEachGroupedLevel(0, side, BOOK_DEPTH, [](int64_t price, int64_t qty, int32_t) {
+                keep(price + qty);
+            });
+        }
+    });
+
+    // A deals frame summed into the batch, on a feed whose scale is known
+    benchmark("feed/spot_deals", 1, [&] {
+        keep(applySpotFrame(trackedFeed, spotDeals, spotStream.snapshots, BOOK_DEPTH));
+        keep(trackedFeed.trades.buyQty);
+    });
+
+    // Statistics over the top of the book the spot stream ends with, as published to the window
+    BenchBook view;
+    view.scale = trackedFeed.scale;
+    trackedFeed.book.forEachLevel(Side::Bid, BOOK_DEPTH, [&view](int64_t price, int64_t qty, int32_t) {
+        view.bids[view.bidCount++] = {price, qty};
+    });
+    trackedFeed.book.forEachLevel(Side::Ask, BOOK_DEPTH, [&view](int64_t price, int64_t qty, int32_t) {
+        view.asks[view.askCount++] = {price, qty};
+    });
+    const DepthCurve& bidCurve = trackedFeed.book.depth(Side::Bid);
+    const DepthCurve& askCurve = trackedFeed.book.depth(Side::Ask);
+    std::copy_n(bidCurve.cumulative.data(), view.bidCount, view.bidDepth);
+    std::copy_n(askCurve.cumulative.data(), view.askCount, view.askDepth);
+    view.bidMaxVolume = bidCurve.maxQty;
+    view.askMaxVolume = askCurve.maxQty;
+    SymbolScale scale = trackedFeed.scale;
+
+    // Mid prices along the stream, as the window sees them frame by frame
+    std::vector<float> mids;
+    startFeed(spotFeed);
+    for (std::string_view frame : spotStream.frames) {
+        applySpotFrame(spotFeed, frame, spotStream.snapshots, BOOK_DEPTH);
+        if (spotFeed.book.bestBid() != OrderBookEngine::NO_PRICE && spotFeed.book.bestAsk() != OrderBookEngine::NO_PRICE) {
+            mids.push_back(static_cast<float>(
+                fixedToDouble(spotFeed.book.bestBid() + spotFeed.book.bestAsk(), scale.priceDecimals) / 2));
+        }
+    }
+
+    benchmark("metrics/calculateOrderBookMetrics", 1, [&] {
+        OrderBookMetrics metrics = calculateOrderBookMetrics(view);
+        keep(metrics.liquidityImbalance);
+    });
+    benchmark("metrics/calculateMarketDepth", 1, [&] {
+        MarketDepthMetrics metrics = calculateMarketDepth(view);
+        keep(metrics.depthImbalanceRatio);
+    });
+    // One book event every 20 ms, so the windows rotate through their buckets
+    TrendTracker trend;
+    int64_t eventNs = 0;
+    benchmark("indicators/onMid", mids.size(), [&] {
+        for (float mid : mids) {
+            eventNs += 20'000'000;
+            trend.onMid(eventNs, mid);
+        }
+        keep(trend.values().momentum);
+    });
+
+    // One deals frame every 5 ms, so the flow window rotates through its buckets
+    OrderFlowTracker flow;
+    int64_t tradeNs = 0;
+    benchmark("indicators/onTrades", 1000, [&] {
+        for (int i = 0; i < 1000; i++) {
+            tradeNs += 5'000'000;
+            flow.onTrades(tradeNs, (i & 3) * 0.25, (i & 1) * 0.5, 3);
+        }
+        keep(flow.values().imbalance);
+    });
+    benchmark("metrics/calculateOrderFlow", 1, [&] {
+        OrderFlowMetrics metrics = calculateOrderFlow(flow.values());
+        keep(metrics.maxFlow);
+    });
+
+    // Volumes across the suffix ranges
+    const float values[] = {0.0042f, 0.5f, 12.75f, 999.99f, 1000.0f, 4521.3f, 87654.321f,
+                            999999.0f, 1000000.0f, 2500000.5f, 123456789.0f, 3.14159f};
+    benchmark("format/formatNumber", std::size(values), [&] {
+        for (float value : values) keep(formatNumber(value)[0]);
+    });
+    const int64_t quantities[] = {42, 5000, 127500, 9999900, 10000000, 45213000, 876543210, 31415900};
+    char quantity[32];
+    benchmark("format/formatQuantity", std::size(quantities), [&] {
+        for (int64_t raw : quantities) keep(formatQuantity(quantity, sizeof(quantity), raw, 4));
+    });
+    return 0;
+}
@@ -0,0 +1,172 @@
+//
+// Headless feed handler: the connections, shard workers and books of the
+// window program, with every book logged instead of drawn. Needs no display
+// and links no raylib.
+//
+//   MEXC_Daemon [BASE/QUOTE...]
+//
+// Each pair is tracked on both markets (ETH/USDT is ETHUSDT on spot and
+// ETH_USDT on futures); MEXC_SPOT_SYMBOLS and MEXC_FUTURES_SYMBOLS add
+// symbols to one market in its own spelling. Without either, ETH/USDT is
+// tracked. Every MEXC_LOG_INTERVAL seconds (default 5, 0 = off) one line per
+// book shows its best levels, depth and publish count, a second its taker
+// flow once it has traded, and one line per pair its futures-spot basis. MEXC_LATENCY_DUMP, MEXC_JOURNAL, MEXC_SHM,
+// MEXC_SPOT_FANOUT / MEXC_FUTURES_FANOUT and the endpoint overrides work as in
+// the window. SIGINT / SIGTERM stop it.
+//
+
+#include "Programs/MEXC_Feed.h"
+#include "Programs/FixedPoint.h"
+
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace net = boost::asio;
+
+// A pair followed on both markets; the symbols are set on the io thread
+struct TrackedPair {
+    std::string base;
+    std::string quote;
+    const SpotFeed::Symbol* spot = nullptr;
+    const FuturesFeed::Symbol* futures = nullptr;
+};
+
+static std::deque<TrackedPair> g_pairs;    // Deque: add() callbacks keep pointers to entries
+
+static void printUsage() {
+    std::cerr << "Usage: MEXC_Daemon [BASE/QUOTE...]\n"
+                 "       MEXC_SPOT_SYMBOLS / MEXC_FUTURES_SYMBOLS add symbols to one market;\n"
+                 "       MEXC_LOG_INTERVAL=<seconds> paces the book log"
+              << std::endl;
+}
+
+// Mid of a published book, 0 while a side is empty
+template <typename View>
+static double midOf(const View& view) {
+    if (!view.bidCount || !view.askCount) return 0;
+    return fixedToDouble(view.bids[0].price + view.asks[0].price, view.scale.priceDecimals) / 2;
+}
+
+// Best levels and depth of one book, read from its published snapshot
+template <typename Venue>
+static void logBook(const typename VenueFeed<Venue>::Symbol& feed) {
+    typename VenueFeed<Venue>::BookView view;
+    feed.snapshot.read(view);
+    const SymbolScale& scale = view.scale;
+    if (!view.bidCount || !view.askCount) {
+        std::printf("%-8s %-14s waiting for the book\n", Venue::NAME, feed.symbol.c_str());
+        return;
+    }
+
+    char bid[32], ask[32], bidQty[32], askQty[32], bidDepth[32], askDepth[32];
+    formatFixed(bid, sizeof(bid), view.bids[0].price, scale.priceDecimals, scale.priceDecimals);
+    formatFixed(ask, sizeof(ask), view.asks[0].price, scale.priceDecimals, scale.priceDecimals);
+    formatFixed(bidQty, sizeof(bidQty), view.bids[0].volume, scale.qtyDecimals, scale.qtyDecimals);
+    formatFixed(askQty, sizeof(askQty), view.asks[0].volume, scale.qtyDecimals, scale.qtyDecimals);
+    formatFixed(bidDepth, sizeof(bidDepth), view.bidBookVolume, scale.qtyDecimals, scale.qtyDecimals);
+    formatFixed(askDepth, sizeof(askDepth), view.askBookVolume, scale.qtyDecimals, scale.qtyDecimals);
+    std::printf("%-8s %-14s bid %s x %s  ask %s x %s  book %s / %s  publishes %llu\n",
+                Venue::NAME, feed.symbol.c_str(), bid, bidQty, ask, askQty, bidDepth, askDepth,
+                static_cast<unsigned long long>(view.version));
+
+    OrderFlow flow;
+    feed.flowSnapshot.read(flow);
+    if (flow.trades == 0 && flow.cumulativeDelta == 0) return;
+    std::printf("%-8s %-14s flow %zus: buy %.6g  sell %.6g  imbalance %+.1f%%  trades %u  cvd %+.6g  vwap %.6g\n",
+                Venue::NAME, feed.symbol.c_str(), OrderFlow::HISTORY, flow.buyVolume, flow.sellVolume,
+                flow.imbalance * 100.0, flow.trades, flow.cumulativeDelta, view.trend.vwap);
+}
+
+template <typename Venue>
+static void logBooks(const VenueFeed<Venue>& feed) {
+    for (size_t i = 0; i < feed.symbolCount(); i++) {
+        if (const auto* symbol = feed.symbol(static_cast<uint32_t>(i))) logBook<Venue>(*symbol);
+    }
+}
+
+static void logAll() {
+    logBooks(g_spotFeed);
+    logBooks(g_futuresFeed);
+    for (const TrackedPair& pair : g_pairs) {
+        if (!pair.spot || !pair.futures) continue;
+        SpotFeed::BookView spot;
+        FuturesFeed::BookView futures;
+        pair.spot->snapshot.read(spot);
+        pair.futures->snapshot.read(futures);
+        double spotMid = midOf(spot);
+        double futuresMid = midOf(futures);
+        if (spotMid <= 0 || futuresMid <= 0) continue;
+
+        double basis = futuresMid - spotMid;
+        std::printf("basis    %s/%-9s %+.6g (%+.4f%%)\n", pair.base.c_str(), pair.quote.c_str(), basis,
+                    basis / spotMid * 100.0);
+    }
+    std::fflush(stdout);
+}
+
+static void scheduleLog(net::steady_timer& timer, long interval) {
+    timer.expires_after(std::chrono::seconds(interval));
+    timer.async_wait([&timer, interval](const boost::system::error_code& ec) {
+        if (ec) return;
+        logAll();
+        scheduleLog(timer, interval);
+    });
+}
+
+static void trackPair(std::string base, std::string quote) {
+    TrackedPair& pair = g_pairs.emplace_back();
+    pair.base = std::move(base);
+    pair.quote = std::move(quote);
+    g_spotFeed.add(pair.base, pair.quote, [&pair](uint32_t index) { pair.spot = g_spotFeed.symbol(index); });
+    g_futuresFeed.add(pair.base, pair.quote, [&pair](uint32_t index) { pair.futures = g_futuresFeed.symbol(index); });
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        size_t slash = arg.find('/');
+        if (slash == std::string_view::npos || slash == 0 || slash + 1 == arg.size()) {
+            printUsage();
+            return 1;
+        }
+        pairs.emplace_back(std::string(arg.substr(0, slash)), std::string(arg.substr(slash + 1)));
+    }
+    if (pairs.empty() && !std::getenv(SpotVenue::SYMBOLS_ENV) && !std::getenv(FuturesVenue::SYMBOLS_ENV)) {
+        pairs.emplace_back("ETH", "USDT");
+    }
+
+    const char* seconds = std::getenv("MEXC_LOG_INTERVAL");
+    long interval = seconds ? std::strtol(seconds, nullptr, 10) : 5L;
+
+    try {
+        MEXC_Feed_Start();
+        for (auto& [base, quote] : pairs) trackPair(base, quote);
+
+        net::steady_timer logTimer(g_ioc);
+        if (interval > 0) scheduleLog(logTimer, interval);
+
+        net::signal_set signals(g_ioc, SIGINT, SIGTERM);
+        signals.async_wait([](const boost::system::error_code& ec, int) {
+            if (!ec) g_ioc.stop();
+        });
+
+        // Serves every connection, its timers and reconnects until a signal arrives
+        g_ioc.run();
+        MEXC_Feed_Stop();
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
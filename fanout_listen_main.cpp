@@ -0,0 +1,214 @@
+//
+// Example subscriber of the multicast fan-out: joins the group, rebuilds the
+// books from the datagrams and recovers over TCP whenever a channel's
+// sequence jumps. Prints every book's best levels once a second, along with
+// the datagram rate, gaps and the feed-to-subscriber latency.
+//
+//   MEXC_Daemon with MEXC_SPOT_FANOUT=239.255.0.1:30001
+//   MEXC_FanoutListen 239.255.0.1:30001 [interface, default 127.0.0.1]
+//
+// The recovery connection goes to the interface address: subscribers on
+// another machine pass the publisher's address there.
+//
+
+#include "Programs/FanoutProtocol.h"
+#include "Programs/FixedPoint.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/multicast.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/read.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace net = boost::asio;
+using net::ip::tcp;
+using net::ip::udp;
+
+struct ListenBook {
+    std::map<int64_t, int64_t, std::greater<int64_t>> bids;   // price -> qty, best first
+    std::map<int64_t, int64_t> asks;
+    int priceDecimals = 0;
+    int qtyDecimals = 0;
+    bool synced = false;        // Built from a Clear, by recovery or in the stream
+    uint64_t version = 0;       // Publish count of the newest record applied
+    uint64_t recovered = 0;     // Version of the recovered snapshot; older live records are skipped
+};
+
+static std::vector<ListenBook> g_books;
+static std::vector<std::string> g_symbols;
+static volatile std::sig_atomic_t g_stop = 0;
+
+static int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void apply(const BookRecord& record, bool live) {
+    if (record.symbol >= g_books.size()) g_books.resize(record.symbol + 1);
+    ListenBook& book = g_books[record.symbol];
+
+    // Live records queued while recovering may be older than the snapshot
+    if (live && record.version <= book.recovered) return;
+
+    if (record.type == BookRecordType::Clear) {
+        book.bids.clear();
+        book.asks.clear();
+        book.synced = true;
+        book.recovered = live ? 0 : record.version;
+    } else if (record.type == BookRecordType::Level && book.synced) {
+        auto set = [&](auto& levels) {
+            if (record.qty == 0) levels.erase(record.price);
+            else levels[record.price] = record.qty;
+        };
+        if (record.side == 0) set(book.bids);
+        else set(book.asks);
+    }
+    book.version = record.version;
+    book.priceDecimals = record.priceDecimals;
+    book.qtyDecimals = record.qtyDecimals;
+}
+
+// Replaces every book with the publisher's snapshot
+static bool recover(net::io_context& ioc, const tcp::endpoint& publisher) {
+    try {
+        tcp::socket socket(ioc);
+        socket.connect(publisher);
+        FanoutRecoveryHeader header;
+        net::read(socket, net::buffer(&header, sizeof(header)));
+        if (header.magic != FANOUT_RECOVERY_MAGIC) {
+            std::cerr << "Recovery: not a fan-out publisher" << std::endl;
+            return false;
+        }
+        std::vector<BookSymbolName> symbols(header.symbolCount);
+        std::vector<BookRecord> records(header.recordCount);
+        net::read(socket, net::buffer(symbols.data(), symbols.size() * sizeof(BookSymbolName)));
+        net::read(socket, net::buffer(records.data(), records.size() * sizeof(BookRecord)));
+
+        g_symbols.clear();
+        for (const BookSymbolName& symbol : symbols) {
+            g_symbols.emplace_back(symbol.name, strnlen(symbol.name, sizeof(symbol.name)));
+        }
+        for (ListenBook& book : g_books) book.synced = false;
+        for (const BookRecord& record : records) apply(record, false);
+        std::cout << "Recovered " << symbols.size() << " symbols, " << records.size() << " records" << std::endl;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Recovery from " << publisher << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string spec = argc > 1 ? argv[1] : "";
+    size_t colon = spec.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+        std::cerr << "Usage: MEXC_FanoutListen <group:port> [interface]" << std::endl;
+        return 1;
+    }
+    std::string interfaceName = argc > 2 ? argv[2] : "127.0.0.1";
+
+    std::signal(SIGINT, [](int) { g_stop = 1; });
+    std::signal(SIGTERM, [](int) { g_stop = 1; });
+
+    try {
+        net::io_context ioc;
+        auto group = net::ip::make_address_v4(spec.substr(0, colon));
+        auto port = static_cast<uint16_t>(std::strtol(spec.c_str() + colon + 1, nullptr, 10));
+        auto interfaceAddress = net::ip::make_address_v4(interfaceName);
+        tcp::endpoint publisher(interfaceAddress, port);
+
+        // Several subscribers on one host share the port
+        udp::socket socket(ioc);
+        socket.open(udp::v4());
+        socket.set_option(net::socket_base::reuse_address(true));
+        socket.bind(udp::endpoint(group.is_multicast() ? net::ip::address_v4::any() : group, port));
+        if (group.is_multicast()) socket.set_option(net::ip::multicast::join_group(group, interfaceAddress));
+        struct timeval timeout = {0, 100000};
+        setsockopt(socket.native_handle(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::cout << "Listening on udp://" << spec << ", recovery from tcp://" << publisher << std::endl;
+        bool needRecovery = true;
+        std::vector<uint64_t> nextSequence;
+        uint64_t packets = 0, gaps = 0, updates = 0;
+        int64_t latencySumNs = 0;
+        int64_t nextPrintNs = monotonicNowNs() + 1000000000LL;
+        alignas(8) char packet[FANOUT_MAX_PACKET];
+
+        while (!g_stop) {
+            if (needRecovery) needRecovery = !recover(ioc, publisher);
+
+            boost::system::error_code ec;
+            size_t bytes = socket.receive(net::buffer(packet), 0, ec);
+            FanoutPacketHeader header;
+            if (!ec && bytes >= sizeof(header)) {
+                std::memcpy(&header, packet, sizeof(header));
+                if (header.magic == FANOUT_PACKET_MAGIC &&
+                    bytes == sizeof(header) + header.count * sizeof(BookRecord)) {
+                    if (header.channel >= nextSequence.size()) nextSequence.resize(header.channel + 1, 0);
+                    uint64_t& expected = nextSequence[header.channel];
+                    if (expected && header.sequence != expected) {
+                        gaps++;
+                        needRecovery = true;
+                    }
+                    expected = header.sequence + 1;
+                    packets++;
+
+                    for (size_t i = 0; i < header.count; i++) {
+                        BookRecord record;
+                        std::memcpy(&record, packet + sizeof(header) + i * sizeof(BookRecord), sizeof(record));
+                        apply(record, true);
+                        if ((record.flags & BOOK_END_OF_UPDATE) && record.recvNs) {
+                            latencySumNs += monotonicNowNs() - record.recvNs;
+                            updates++;
+                        }
+                    }
+                }
+            }
+
+            int64_t nowNs = monotonicNowNs();
+            if (nowNs < nextPrintNs) continue;
+            nextPrintNs = nowNs + 1000000000LL;
+
+            for (size_t i = 0; i < g_books.size(); i++) {
+                const ListenBook& book = g_books[i];
+                const char* symbol = i < g_symbols.size() ? g_symbols[i].c_str() : "?";
+                if (!book.synced || book.bids.empty() || book.asks.empty()) {
+                    std::printf("%-14s waiting for a snapshot\n", symbol);
+                    continue;
+                }
+                char bid[48], ask[48], bidQty[48], askQty[48];
+                const auto& [bidPrice, bidVolume] = *book.bids.begin();
+                const auto& [askPrice, askVolume] = *book.asks.begin();
+                formatFixed(bid, sizeof(bid), bidPrice, book.priceDecimals, book.priceDecimals);
+                formatFixed(ask, sizeof(ask), askPrice, book.priceDecimals, book.priceDecimals);
+                formatFixed(bidQty, sizeof(bidQty), bidVolume, book.qtyDecimals, book.qtyDecimals);
+                formatFixed(askQty, sizeof(askQty), askVolume, book.qtyDecimals, book.qtyDecimals);
+                std::printf("%-14s bid %s x %s  ask %s x %s  levels %zu / %zu  version %llu\n", symbol, bid,
+                            bidQty, ask, askQty, book.bids.size(), book.asks.size(),
+                            static_cast<unsigned long long>(book.version));
+            }
+            std::printf("%llu datagrams, %llu updates, %llu gaps, mean feed->subscriber %.1f us\n",
+                        static_cast<unsigned long long>(packets), static_cast<unsigned long long>(updates),
+                        static_cast<unsigned long long>(gaps), updates ? latencySumNs / 1000.0 / updates : 0.0);
+            std::fflush(stdout);
+            packets = 0;
+            updates = 0;
+            latencySumNs = 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,608 @@
+//
+// Local stand-in for the MEXC websocket and depth endpoints, for testing and
+// load testing the client without the exchange.
+//
+//   MEXC_MockServer [--port 9443] [--rate <msgs/s per stream>] [--churn <levels>]
+//                   [--levels <per side>] [--move <probability>] [--seed <n>]
+//                   [--max-queue <frames>] [--cert <pem> --key <pem>]
+//
+// One TLS port serves:
+//   wss://host:port/ws      spot: SUBSCRIPTION/UNSUBSCRIPTION of increase.depth,
+//                           limit.depth, bookTicker and deals streams, PING
+//   wss://host:port/edge    futures: sub.depth, sub.depth.full, sub.deal (and
+//                           unsub.*), ping
+//   GET /api/v3/depth?symbol=<s>[&limit=<n>]      spot depth snapshot
+//   GET /api/v1/contract/depth/<symbol>           futures depth snapshot
+//
+// Every subscribed symbol is a random-walk book (SyntheticBook) stepped
+// --rate times per second; each step is pushed to every stream of the symbol.
+// Snapshots are taken from the same books, so diff streams resynchronise the
+// way they do against MEXC. A client whose queue of unsent frames passes
+// --max-queue is disconnected, like a slow consumer on the exchange.
+//
+// Without --cert/--key a self-signed certificate is made at startup; the
+// client does not verify certificates. Point the client at the server with
+//   MEXC_SPOT_ENDPOINT=wss://127.0.0.1:9443/ws
+//   MEXC_SPOT_SNAPSHOT=https://127.0.0.1:9443/api/v3/depth?symbol={symbol}&limit=5000
+//   MEXC_FUTURES_ENDPOINT=wss://127.0.0.1:9443/edge
+//   MEXC_FUTURES_SNAPSHOT=https://127.0.0.1:9443/api/v1/contract/depth/{symbol}
+//
+
+#include "Programs/SyntheticMarket.h"
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = net::ip::tcp;
+using json = nlohmann::json;
+
+using WsStream = websocket::stream<beast::ssl_stream<beast::tcp_stream>>;
+using Frame = std::shared_ptr<const std::string>;
+
+struct MockConfig {
+    unsigned short port = 9443;
+    double rate = 100;              // Book steps per second per symbol
+    size_t churn = 4;
+    size_t levels = 200;
+    double moveProbability = 0.3;
+    uint64_t seed = 1;
+    size_t maxQueue = 100000;
+    std::string certFile;
+    std::string keyFile;
+};
+
+static MockConfig g_config;
+static net::io_context g_ioc;
+static ssl::context g_ctx{ssl::context::tls_server};
+
+enum class StreamKind {
+    SpotDepthDelta, SpotLimitDepth, SpotBookTicker, SpotDeals, FuturesDepth, FuturesDepthFull, FuturesDeal, Count
+};
+
+class MockClient;
+
+struct Subscription {
+    MockClient* client;
+    size_t depth;                   // Levels of a limited/full depth stream
+};
+
+// A symbol's book and the streams subscribed to it. Spot and futures symbols
+// never collide ("BTCUSDT" vs "BTC_USDT"), so they share one map.
+struct MockMarket {
+    std::unique_ptr<SyntheticBook> book;
+    std::vector<Subscription> streams[static_cast<size_t>(StreamKind::Count)];
+    int64_t tickerBid = 0;
+    int64_t tickerAsk = 0;
+
+    bool idle() const {
+        for (const auto& subscriptions : streams) {
+            if (!subscriptions.empty()) return false;
+        }
+        return true;
+    }
+};
+
+static std::map<std::string, MockMarket, std::less<>> g_markets;
+
+// Counters for the periodic report
+static uint64_t g_framesSent = 0;
+static uint64_t g_bytesSent = 0;
+static uint64_t g_slowClosed = 0;
+static size_t g_clientCount = 0;
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Stable start price per symbol so restarts produce similar books
+static MockMarket& marketFor(const std::string& symbol) {
+    auto found = g_markets.find(symbol);
+    if (found != g_markets.end()) return found->second;
+
+    bool futures = symbol.find('_') != std::string::npos;
+    uint64_t hash = 1469598103934665603ull;
+    for (char c : symbol) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+
+    SyntheticBook::Options options;
+    options.priceDecimals = futures ? 1 : 2;
+    options.qtyDecimals = futures ? 0 : 4;
+    options.startPrice = static_cast<int64_t>(1000 + hash % 500000);
+    options.levels = g_config.levels;
+    options.churn = g_config.churn;
+    options.moveProbability = g_config.moveProbability;
+    options.seed = g_config.seed ^ hash;
+
+    MockMarket& market = g_markets[symbol];
+    market.book = std::make_unique<SyntheticBook>(symbol, options);
+    return market;
+}
+
+class MockClient : public std::enable_shared_from_this<MockClient> {
+public:
+    MockClient(std::shared_ptr<WsStream> ws, bool futures)
+        : m_ws(std::move(ws)), m_futures(futures) {}
+
+    net::awaitable<void> run();
+    void send(Frame frame);
+    void send(std::string text) { send(std::make_shared<const std::string>(std::move(text))); }
+
+private:
+    net::awaitable<void> writeOutbox();
+    void handleSpot(const json& request);
+    void handleFutures(const json& request);
+    void subscribe(const std::string& symbol, StreamKind kind, size_t depth);
+    void unsubscribe(const std::string& symbol, StreamKind kind);
+    void close();
+
+    std::shared_ptr<WsStream> m_ws;
+    bool m_futures;
+    std::deque<Frame> m_outbox;
+    bool m_writing = false;
+    bool m_closed = false;
+    std::vector<std::pair<std::string, StreamKind>> m_subscriptions;
+};
+
+void MockClient::send(Frame frame) {
+    if (m_closed) return;
+    if (m_outbox.size() >= g_config.maxQueue) {
+        std::cerr << "Client fell " << m_outbox.size() << " frames behind, disconnecting" << std::endl;
+        g_slowClosed++;
+        close();
+        return;
+    }
+    m_outbox.push_back(std::move(frame));
+    if (!m_writing) {
+        m_writing = true;
+        net::co_spawn(g_ioc, [self = shared_from_this()] { return self->writeOutbox(); }, net::detached);
+    }
+}
+
+net::awaitable<void> MockClient::writeOutbox() {
+    while (!m_closed && !m_outbox.empty()) {
+        Frame frame = m_outbox.front();
+        beast::error_code ec;
+        co_await m_ws->async_write(net::buffer(*frame), net::redirect_error(net::use_awaitable, ec));
+        if (ec || m_closed) {
+            close();
+            break;
+        }
+        m_outbox.pop_front();
+        g_framesSent++;
+        g_bytesSent += frame->size();
+    }
+    m_writing = false;
+}
+
+// Drops the client from every stream; the read loop ends on the closed socket
+void MockClient::close() {
+    if (m_closed) return;
+    m_closed = true;
+    while (!m_subscriptions.empty()) {
+        auto [symbol, kind] = m_subscriptions.back();
+        unsubscribe(symbol, kind);
+    }
+    m_outbox.clear();
+    beast::error_code ec;
+    beast::get_lowest_layer(*m_ws).socket().close(ec);
+}
+
+void MockClient::subscribe(const std::string& symbol, StreamKind kind, size_t depth) {
+    MockMarket& market = marketFor(symbol);
+    auto& subscriptions = market.streams[static_cast<size_t>(kind)];
+    for (const Subscription& subscription : subscriptions) {
+        if (subscription.client == this) return;
+    }
+    subscriptions.push_back({this, depth});
+    m_subscriptions.emplace_back(symbol, kind);
+}
+
+void MockClient::unsubscribe(const std::string& symbol, StreamKind kind) {
+    for (size_t i = 0; i < m_subscriptions.size(); i++) {
+        if (m_subscriptions[i].first == symbol && m_subscriptions[i].second == kind) {
+            m_subscriptions.erase(m_subscriptions.begin() + static_cast<std::ptrdiff_t>(i));
+            break;
+        }
+    }
+    auto found = g_markets.find(symbol);
+    if (found == g_markets.end()) return;
+    auto& subscriptions = found->second.streams[static_cast<size_t>(kind)];
+    std::erase_if(subscriptions, [this](const Subscription& s) { return s.client == this; });
+}
+
+// Spot stream names: spot@public.<stream>.v3.api@<SYMBOL>[@<levels>]
+static bool parseSpotStream(const std::string& name, std::string& symbol, StreamKind& kind, size_t& depth) {
+    static const std::pair<std::string_view, StreamKind> prefixes[] = {
+        {"spot@public.increase.depth.v3.api@", StreamKind::SpotDepthDelta},
+        {"spot@public.limit.depth.v3.api@", StreamKind::SpotLimitDepth},
+        {"spot@public.bookTicker.v3.api@", StreamKind::SpotBookTicker},
+        {"spot@public.deals.v3.api@", StreamKind::SpotDeals},
+    };
+    for (const auto& [prefix, streamKind] : prefixes) {
+        if (name.rfind(prefix, 0) != 0) continue;
+        std::string rest = name.substr(prefix.size());
+        size_t at = rest.find('@');
+        symbol = rest.substr(0, at);
+        kind = streamKind;
+        depth = at == std::string::npos ? 20 : std::strtoul(rest.c_str() + at + 1, nullptr, 10);
+        if (depth == 0) depth = 20;
+        return !symbol.empty();
+    }
+    return false;
+}
+
+void MockClient::handleSpot(const json& request) {
+    std::string method = request.value("method", "");
+    int64_t id = request.value("id", 0);
+
+    if (method == "PING") {
+        send(json{{"id", id}, {"code", 0}, {"msg", "PONG"}}.dump());
+        return;
+    }
+    if (method != "SUBSCRIPTION" && method != "UNSUBSCRIPTION") {
+        send(json{{"id", id}, {"code", 1}, {"msg", "Unsupported method " + method}}.dump());
+        return;
+    }
+
+    std::vector<std::string> accepted;
+    if (request.contains("params") && request["params"].is_array()) {
+        for (const auto& param : request["params"]) {
+            if (!param.is_string()) continue;
+            std::string name = param.get<std::string>();
+            std::string symbol;
+            StreamKind kind;
+            size_t depth;
+            if (!parseSpotStream(name, symbol, kind, depth)) {
+                send(json{{"id", id}, {"code", 1}, {"msg", "Not Subscribed successfully! [" + name + "]"}}.dump());
+                continue;
+            }
+            if (method == "SUBSCRIPTION") subscribe(symbol, kind, depth);
+            else unsubscribe(symbol, kind);
+            accepted.push_back(name);
+        }
+    }
+
+    std::string joined;
+    for (const std::string& name : accepted) {
+        if (!joined.empty()) joined += ',';
+        joined += name;
+    }
+    if (!accepted.empty()) send(json{{"id", id}, {"code", 0}, {"msg", joined}}.dump());
+}
+
+void MockClient::handleFutures(const json& request) {
+    std::string method = request.value("method", "");
+
+    if (method == "ping") {
+        send(json{{"channel", "pong"}, {"data", nowMs()}}.dump());
+        return;
+    }
+
+    std::string symbol;
+    size_t depth = 20;
+    if (request.contains("param") && request["param"].is_object()) {
+        symbol = request["param"].value("symbol", "");
+        depth = request["param"].value("limit", 20);
+    }
+
+    StreamKind kind;
+    bool add = true;
+    if (method == "sub.depth") kind = StreamKind::FuturesDepth;
+    else if (method == "sub.depth.full") kind = StreamKind::FuturesDepthFull;
+    else if (method == "sub.deal") kind = StreamKind::FuturesDeal;
+    else if (method == "unsub.depth") kind = StreamKind::FuturesDepth, add = false;
+    else if (method == "unsub.depth.full") kind = StreamKind::FuturesDepthFull, add = false;
+    else if (method == "unsub.deal") kind = StreamKind::FuturesDeal, add = false;
+    else {
+        send(json{{"channel", "rs.error"}, {"data", "unsupported method " + method}, {"ts", nowMs()}}.dump());
+        return;
+    }
+    if (symbol.empty()) {
+        send(json{{"channel", "rs.error"}, {"data", "symbol missing"}, {"ts", nowMs()}}.dump());
+        return;
+    }
+
+    if (add) subscribe(symbol, kind, depth == 0 ? 20 : depth);
+    else unsubscribe(symbol, kind);
+    send(json{{"channel", "rs." + method}, {"data", "success"}, {"ts", nowMs()}}.dump());
+}
+
+net::awaitable<void> MockClient::run() {
+    auto self = shared_from_this();
+    g_clientCount++;
+    beast::flat_buffer buffer;
+    for (;;) {
+        beast::error_code ec;
+        co_await m_ws->async_read(buffer, net::redirect_error(net::use_awaitable, ec));
+        if (ec || m_closed) break;
+
+        std::string_view text(static_cast<const char*>(buffer.data().data()), buffer.size());
+        json request = json::parse(text, nullptr, false);
+        buffer.consume(buffer.size());
+        if (request.is_discarded() || !request.is_object()) continue;
+
+        if (m_futures) handleFutures(request);
+        else handleSpot(request);
+    }
+    close();
+    g_clientCount--;
+}
+
+// Pushes one book step to every stream of the market
+static void stepMarket(MockMarket& market, int64_t timeMs) {
+    SyntheticBook& book = *market.book;
+    const std::vector<SyntheticBook::Change>& changes = book.step();
+
+    auto publish = [&](StreamKind kind, auto&& format) {
+        auto& subscriptions = market.streams[static_cast<size_t>(kind)];
+        if (subscriptions.empty()) return;
+        // Streams of the same depth share one formatted frame
+        Frame frame;
+        size_t frameDepth = 0;
+        // send() may close a slow client, which removes it from this list
+        auto copy = subscriptions;
+        for (const Subscription& subscription : copy) {
+            if (!frame || subscription.depth != frameDepth) {
+                frame = std::make_shared<const std::string>(format(subscription.depth));
+                frameDepth = subscription.depth;
+            }
+            subscription.client->send(frame);
+        }
+    };
+
+    publish(StreamKind::SpotDepthDelta, [&](size_t) { return spotDepthDeltaFrame(book, changes, timeMs); });
+    publish(StreamKind::SpotLimitDepth, [&](size_t depth) { return spotLimitDepthFrame(book, depth, timeMs); });
+    if (book.bestBid() != market.tickerBid || book.bestAsk() != market.tickerAsk) {
+        market.tickerBid = book.bestBid();
+        market.tickerAsk = book.bestAsk();
+        publish(StreamKind::SpotBookTicker, [&](size_t) { return spotBookTickerFrame(book, timeMs); });
+    }
+    publish(StreamKind::FuturesDepth, [&](size_t) { return futuresDepthDeltaFrame(book, changes, timeMs); });
+    publish(StreamKind::FuturesDepthFull, [&](size_t depth) { return futuresDepthFullFrame(book, depth, timeMs); });
+    if (!book.trades().empty()) {
+        publish(StreamKind::SpotDeals, [&](size_t) { return spotDealsFrame(book, timeMs); });
+        publish(StreamKind::FuturesDeal, [&](size_t) { return futuresDealFrame(book, timeMs); });
+    }
+}
+
+// Steps every subscribed book at the configured rate. Steps owed since the
+// last tick are made up in a burst, capped at one second's worth.
+static net::awaitable<void> runMarkets() {
+    net::steady_timer timer(g_ioc);
+    auto last = std::chrono::steady_clock::now();
+    auto lastReport = last;
+    uint64_t reportedFrames = 0;
+    uint64_t reportedBytes = 0;
+    double owed = 0;
+
+    for (;;) {
+        timer.expires_after(std::chrono::milliseconds(1));
+        co_await timer.async_wait(net::use_awaitable);
+
+        auto now = std::chrono::steady_clock::now();
+        owed += g_config.rate * std::chrono::duration<double>(now - last).count();
+        if (owed > g_config.rate) owed = g_config.rate;
+        last = now;
+
+        auto steps = static_cast<uint64_t>(owed);
+        owed -= static_cast<double>(steps);
+        if (steps > 0) {
+            int64_t timeMs = nowMs();
+            for (auto& [symbol, market] : g_markets) {
+                if (market.idle()) continue;
+                for (uint64_t i = 0; i < steps; i++) stepMarket(market, timeMs);
+            }
+        }
+
+        if (now - lastReport >= std::chrono::seconds(5)) {
+            double seconds = std::chrono::duration<double>(now - lastReport).count();
+            printf("clients %zu  symbols %zu  %.0f msgs/s  %.2f MB/s  slow disconnects %llu\n",
+                   g_clientCount, g_markets.size(),
+                   static_cast<double>(g_framesSent - reportedFrames) / seconds,
+                   static_cast<double>(g_bytesSent - reportedBytes) / seconds / 1e6,
+                   static_cast<unsigned long long>(g_slowClosed));
+            fflush(stdout);
+            reportedFrames = g_framesSent;
+            reportedBytes = g_bytesSent;
+            lastReport = now;
+        }
+    }
+}
+
+// Answers a REST depth request from the live books
+static http::response<http::string_body> snapshotResponse(const http::request<http::string_body>& request) {
+    std::string target(request.target());
+    std::string body;
+    http::status status = http::status::ok;
+
+    auto queryValue = [&target](const char* key) -> std::string {
+        std::string needle = std::string(key) + "=";
+        size_t pos = target.find(needle);
+        if (pos == std::string::npos) return {};
+        pos += needle.size();
+        return target.substr(pos, target.find('&', pos) - pos);
+    };
+
+    if (target.rfind("/api/v3/depth", 0) == 0) {
+        std::string symbol = queryValue("symbol");
+        std::string limit = queryValue("limit");
+        size_t levels = limit.empty() ? 100 : std::strtoul(limit.c_str(), nullptr, 10);
+        if (symbol.empty()) {
+            status = http::status::bad_request;
+            body = R"({"code":-1100,"msg":"symbol missing"})";
+        } else {
+            body = spotDepthSnapshot(*marketFor(symbol).book, levels);
+        }
+    } else if (target.rfind("/api/v1/contract/depth/", 0) == 0) {
+        std::string symbol = target.substr(std::strlen("/api/v1/contract/depth/"));
+        symbol = symbol.substr(0, symbol.find('?'));
+        body = futuresDepthSnapshot(*marketFor(symbol).book, g_config.levels, nowMs());
+    } else {
+        status = http::status::not_found;
+        body = R"({"code":404,"msg":"not found"})";
+    }
+
+    http::response<http::string_body> response{status, request.version()};
+    response.set(http::field::content_type, "application/json");
+    response.keep_alive(request.keep_alive());
+    response.body() = std::move(body);
+    response.prepare_payload();
+    return response;
+}
+
+static net::awaitable<void> serve(tcp::socket socket) {
+    try {
+        beast::ssl_stream<beast::tcp_stream> stream(std::move(socket), g_ctx);
+        beast::get_lowest_layer(stream).expires_after(std::chrono::seconds(10));
+        co_await stream.async_handshake(ssl::stream_base::server, net::use_awaitable);
+
+        beast::flat_buffer buffer;
+        for (;;) {
+            http::request<http::string_body> request;
+            co_await http::async_read(stream, buffer, request, net::use_awaitable);
+
+            if (websocket::is_upgrade(request)) {
+                std::string_view target(request.target().data(), request.target().size());
+                bool futures = target.rfind("/edge", 0) == 0;
+                if (!futures && target.rfind("/ws", 0) != 0) co_return;
+
+                // The websocket has its own keep-alive; the client pings
+                beast::get_lowest_layer(stream).expires_never();
+                auto ws = std::make_shared<WsStream>(std::move(stream));
+                ws->set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+                co_await ws->async_accept(request, net::use_awaitable);
+
+                auto client = std::make_shared<MockClient>(ws, futures);
+                co_await client->run();
+                co_return;
+            }
+
+            auto response = snapshotResponse(request);
+            bool keepAlive = response.keep_alive();
+            co_await http::async_write(stream, response, net::use_awaitable);
+            if (!keepAlive) break;
+            beast::get_lowest_layer(stream).expires_after(std::chrono::seconds(10));
+        }
+    }
+    catch (const std::exception&) {
+        // Clients dropping the connection end up here
+    }
+}
+
+static net::awaitable<void> listen(tcp::acceptor& acceptor) {
+    for (;;) {
+        tcp::socket socket = co_await acceptor.async_accept(net::use_awaitable);
+        socket.set_option(tcp::no_delay(true));
+        net::co_spawn(g_ioc, serve(std::move(socket)), net::detached);
+    }
+}
+
+// Self-signed P-256 certificate for "localhost", valid for a year
+static bool useSelfSignedCertificate(ssl::context& ctx) {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    bool ok = key && cert;
+    if (ok) {
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 365L * 24 * 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0 &&
+             SSL_CTX_use_certificate(ctx.native_handle(), cert) == 1 &&
+             SSL_CTX_use_PrivateKey(ctx.native_handle(), key) == 1;
+    }
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: MEXC_MockServer [--port 9443] [--rate <msgs/s per stream>] [--churn <levels>]\n"
+                 "                       [--levels <per side>] [--move <probability>] [--seed <n>]\n"
+                 "                       [--max-queue <frames>] [--cert <pem> --key <pem>]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view flag = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (flag == "--port") g_config.port = static_cast<unsigned short>(std::atoi(value));
+        else if (flag == "--rate") g_config.rate = std::atof(value);
+        else if (flag == "--churn") g_config.churn = std::strtoul(value, nullptr, 10);
+        else if (flag == "--levels") g_config.levels = std::strtoul(value, nullptr, 10);
+        else if (flag == "--move") g_config.moveProbability = std::atof(value);
+        else if (flag == "--seed") g_config.seed = std::strtoull(value, nullptr, 10);
+        else if (flag == "--max-queue") g_config.maxQueue = std::strtoul(value, nullptr, 10);
+        else if (flag == "--cert") g_config.certFile = value;
+        else if (flag == "--key") g_config.keyFile = value;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    try {
+        if (!g_config.certFile.empty()) {
+            g_ctx.use_certificate_chain_file(g_config.certFile);
+            g_ctx.use_private_key_file(g_config.keyFile, ssl::context::pem);
+        } else if (!useSelfSignedCertificate(g_ctx)) {
+            std::cerr << "Could not create a self-signed certificate" << std::endl;
+            return 1;
+        }
+
+        tcp::acceptor acceptor(g_ioc, {tcp::v4(), g_config.port});
+        std::cout << "MEXC mock server on wss://127.0.0.1:" << g_config.port << " (/ws spot, /edge futures), "
+                  << g_config.rate << " steps/s per symbol, churn " << g_config.churn << std::endl;
+
+        net::co_spawn(g_ioc, listen(acceptor), net::detached);
+        net::co_spawn(g_ioc, runMarkets(), net::detached);
+        g_ioc.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Mock server error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
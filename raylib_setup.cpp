@@ -5,19 +5,33 @@
 
 #include <raylib.h>
 #include <iostream>
-#include "Programs/OrderBook_MEXC_Spot.h"
+#include "Programs/OrderBook_MEXC.h"
 #include <vector>
 #include <thread>
 
 #include "raylib_setup.h"
 
 Font g_font;  // Definition of the global variable
+
+// Any key, mouse button, wheel or pointer movement since the last poll. Only
+// reads state, so the char queue is left for the text inputs.
+static bool inputActive() {
+    Vector2 delta = GetMouseDelta();
+    if (delta.x != 0 || delta.y != 0 || GetMouseWheelMove() != 0) return true;
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++) {
+        if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button)) return true;
+    }
+    for (int key = KEY_SPACE; key <= KEY_KB_MENU; key++) {
+        if (IsKeyPressed(key) || IsKeyReleased(key)) return true;
+    }
+    return false;
+}
 int raylib_start() {
     const int screenWidth = 500;
     const int screenHeight = 640;
 
     SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_MSAA_4X_HINT);
-    InitWindow(screenWidth, screenHeight, "MEXC OrderBook Futures");
+    InitWindow(screenWidth, screenHeight, "MEXC OrderBook");
 
     // Load custom font
     g_font = LoadFontEx("./resources/Kanit/Kanit-Regular.ttf", 64, nullptr, 0);
@@ -29,14 +43,34 @@ int raylib_start() {
     std::thread ws_thread(MEXC_Connection);
     ws_thread.detach();
 
+    // Frames are drawn only when the book, the window or the input changed;
+    // otherwise the last one stays on screen and the loop just polls
+    const double IDLE_POLL_SECONDS = 1.0 / 120;
+    const double IDLE_REDRAW_SECONDS = 1.0;
+    double lastDraw = -IDLE_REDRAW_SECONDS;
+    int drawnWidth = 0;
+    int drawnHeight = 0;
+
     while (!WindowShouldClose()) {
+        bool changed = RL_MEXC_Orderbook_Changed() || inputActive() || IsWindowResized() ||
+                       GetScreenWidth() != drawnWidth || GetScreenHeight() != drawnHeight ||
+                       GetTime() - lastDraw >= IDLE_REDRAW_SECONDS;
+        if (!changed) {
+            WaitTime(IDLE_POLL_SECONDS);
+            PollInputEvents();
+            continue;
+        }
+        lastDraw = GetTime();
+        drawnWidth = GetScreenWidth();
+        drawnHeight = GetScreenHeight();
+
         BeginDrawing();
         ClearBackground(BLACK);
 
-        // OrderBook_MEXC_Spot.cpp and OrderBook_MEXC_Futures.cpp has same function name: RL_MEXC_Orderbook_Spot();
-        // No need to change that. only in CMAKE
-        RL_MEXC_Orderbook_Spot();
+        // Spot or futures, whichever is selected in the topbar
+        RL_MEXC_Orderbook();
         EndDrawing();
+        RL_MEXC_Orderbook_Presented();
     }
 
     UnloadFont(g_font);
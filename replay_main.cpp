@@ -0,0 +1,166 @@
+//
+// Replays a frame journal through the same parse -> sequence -> apply path
+// as the live feed, without a socket or a window.
+//
+//   MEXC_Replay <journal-dir> <spot|futures> [--pace <speed>]
+//
+// Without --pace (or with 0) frames are applied back to back. --pace 1
+// sleeps to reproduce the recorded arrival times, 2 plays twice as fast.
+// Prints throughput, the latency of each apply, and a checksum of every
+// final book, so two runs over the same journal can be compared.
+//
+// A symbol's book is dropped at each JOURNAL_RESET marker, where the live
+// feed's stream for it (re)started, and rebuilt from the frames that follow.
+//
+// Diff streams are not resynchronised from REST unless MEXC_SPOT_SNAPSHOT /
+// MEXC_FUTURES_SNAPSHOT is set; without it the replay is deterministic.
+//
+
+#include "Programs/FrameJournal.h"
+#include "Programs/MarketFeed.h"
+#include "Programs/MexcParser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Level count of the limited spot streams, as in the live program
+constexpr size_t SPOT_LIMITED_DEPTH = 20;
+
+static void printUsage() {
+    std::cerr << "Usage: MEXC_Replay <journal-dir> <spot|futures> [--pace <speed>]" << std::endl;
+}
+
+static int64_t percentile(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    std::string directory = argv[1];
+    std::string venue = argv[2];
+    if (venue != "spot" && venue != "futures") {
+        printUsage();
+        return 1;
+    }
+    bool spot = venue == "spot";
+
+    double pace = 0;
+    for (int i = 3; i < argc; i++) {
+        if (std::strcmp(argv[i], "--pace") == 0 && i + 1 < argc) {
+            pace = std::atof(argv[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    SnapshotSource snapshots = snapshotSourceFromEnv(spot ? "MEXC_SPOT_SNAPSHOT" : "MEXC_FUTURES_SNAPSHOT", {});
+    std::string_view symbolKey = spot ? "s" : "symbol";
+
+    // Books by symbol; entries never move once created
+    std::unordered_map<std::string, std::unique_ptr<FeedState>> feeds;
+    std::vector<int64_t> applyNs;
+    applyNs.reserve(1 << 20);
+
+    uint64_t frames = 0;
+    uint64_t updates = 0;
+    uint64_t trades = 0;
+    uint64_t skipped = 0;
+    uint64_t resets = 0;
+    int64_t firstRecvNs = 0;
+
+    JournalReader reader(directory, venue);
+    JournalReader::Frame frame;
+    auto started = std::chrono::steady_clock::now();
+
+    while (reader.next(frame)) {
+        if (frame.flags & JOURNAL_RESET) {
+            // As the live shard does on Reset: the book is rebuilt from the new stream
+            auto found = feeds.find(std::string(frame.text));
+            if (found != feeds.end()) found->second->reset();
+            resets++;
+            continue;
+        }
+        frames++;
+
+        if (pace > 0) {
+            if (frames == 1) firstRecvNs = frame.recvNs;
+            auto due = started + std::chrono::nanoseconds(
+                static_cast<int64_t>(static_cast<double>(frame.recvNs - firstRecvNs) / pace));
+            std::this_thread::sleep_until(due);
+        }
+
+        std::string_view symbol;
+        if (!peekString(frame.text, symbolKey, symbol)) {
+            skipped++;  // Subscription replies, pongs
+            continue;
+        }
+        auto found = feeds.find(std::string(symbol));
+        if (found == feeds.end()) {
+            found = feeds.emplace(std::string(symbol), std::make_unique<FeedState>()).first;
+            found->second->symbol = found->first;
+        }
+        FeedState& feed = *found->second;
+
+        auto before = std::chrono::steady_clock::now();
+        FeedResult result = spot ? applySpotFrame(feed, frame.text, snapshots, SPOT_LIMITED_DEPTH)
+                                 : applyFuturesFrame(feed, frame.text, snapshots);
+        auto after = std::chrono::steady_clock::now();
+
+        applyNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+        if (result == FeedResult::Updated) updates++;
+        if (result == FeedResult::Traded) trades += feed.trades.count;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    if (reader.segmentsRead() == 0) {
+        std::cerr << "No " << venue << " journal segments in " << directory << std::endl;
+        return 1;
+    }
+
+    std::sort(applyNs.begin(), applyNs.end());
+    printf("Frames:     %llu in %u segment(s), %llu without a symbol, %llu stream reset(s)\n",
+           static_cast<unsigned long long>(frames), reader.segmentsRead(),
+           static_cast<unsigned long long>(skipped), static_cast<unsigned long long>(resets));
+    printf("Applied:    %zu, %llu changed a book, %llu trades\n", applyNs.size(),
+           static_cast<unsigned long long>(updates), static_cast<unsigned long long>(trades));
+    printf("Elapsed:    %.3f s, %.0f msgs/sec\n", seconds, seconds > 0 ? static_cast<double>(frames) / seconds : 0.0);
+    printf("Apply (ns): p50 %lld  p90 %lld  p99 %lld  p99.9 %lld  max %lld\n",
+           static_cast<long long>(percentile(applyNs, 50)),
+           static_cast<long long>(percentile(applyNs, 90)),
+           static_cast<long long>(percentile(applyNs, 99)),
+           static_cast<long long>(percentile(applyNs, 99.9)),
+           static_cast<long long>(applyNs.empty() ? 0 : applyNs.back()));
+
+    // Checksums in symbol order, folded into one for the whole replay
+    std::map<std::string_view, const FeedState*> ordered;
+    for (const auto& [symbol, feed] : feeds) ordered.emplace(symbol, feed.get());
+
+    uint64_t combined = 1469598103934665603ull;
+    for (const auto& [symbol, feed] : ordered) {
+        uint64_t checksum = feed->book.checksum();
+        printf("Book %-16.*s %016llx  (%zu asks, %zu bids)\n", static_cast<int>(symbol.size()), symbol.data(),
+               static_cast<unsigned long long>(checksum),
+               feed->book.askCount(), feed->book.bidCount());
+        combined = (combined ^ checksum) * 1099511628211ull;
+    }
+    printf("Checksum:   %016llx over %zu book(s)\n", static_cast<unsigned long long>(combined), ordered.size());
+    return 0;
+}
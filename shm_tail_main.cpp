@@ -0,0 +1,136 @@
+//
+// Example reader of the shared-memory rings a feed writes with MEXC_SHM set:
+// rebuilds every book from the records and prints its best levels once a
+// second, along with the record rate and the feed-to-reader latency.
+//
+//   MEXC_Daemon with MEXC_SHM=/mexc      writes /mexc_spot and /mexc_futures
+//   MEXC_ShmTail /mexc_spot [seconds]
+//
+// Links only MEXC_Shm. Any number of tails can read the same segment.
+//
+
+#include "Programs/ShmRing.h"
+#include "Programs/FixedPoint.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TailBook {
+    std::map<int64_t, int64_t, std::greater<int64_t>> bids;   // price -> qty, best first
+    std::map<int64_t, int64_t> asks;
+    int priceDecimals = 0;
+    int qtyDecimals = 0;
+    bool synced = false;        // A Clear was seen since the start or the last gap
+    uint64_t version = 0;
+};
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void apply(TailBook& book, const BookRecord& record) {
+    if (record.type == BookRecordType::Clear) {
+        book.bids.clear();
+        book.asks.clear();
+        book.synced = true;
+    } else if (record.type == BookRecordType::Level && book.synced) {
+        auto set = [&](auto& levels) {
+            if (record.qty == 0) levels.erase(record.price);
+            else levels[record.price] = record.qty;
+        };
+        if (record.side == 0) set(book.bids);
+        else set(book.asks);
+    }
+    book.priceDecimals = record.priceDecimals;
+    book.qtyDecimals = record.qtyDecimals;
+    book.version = record.version;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: MEXC_ShmTail <segment, e.g. /mexc_spot> [seconds]" << std::endl;
+        return 1;
+    }
+    std::string name = argv[1];
+    long interval = argc > 2 ? std::strtol(argv[2], nullptr, 10) : 1L;
+    if (interval <= 0) interval = 1;
+
+    std::signal(SIGINT, [](int) { g_stop = 1; });
+    std::signal(SIGTERM, [](int) { g_stop = 1; });
+
+    ShmFeedReader reader(name);
+    while (!reader.open()) {
+        if (g_stop) return 0;
+        std::cerr << "Waiting for " << name << "..." << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    std::cout << "Reading " << reader.venue() << " books from " << name << std::endl;
+
+    std::vector<TailBook> books;
+    uint64_t records = 0;
+    uint64_t updates = 0;
+    int64_t latencySumNs = 0;
+    int64_t nextPrintNs = monotonicNowNs() + interval * 1000000000LL;
+
+    while (!g_stop) {
+        size_t read = reader.poll(
+            [&](const BookRecord& record) {
+                if (record.symbol >= books.size()) books.resize(record.symbol + 1);
+                apply(books[record.symbol], record);
+                records++;
+                if ((record.flags & BOOK_END_OF_UPDATE) && record.recvNs) {
+                    latencySumNs += monotonicNowNs() - record.recvNs;
+                    updates++;
+                }
+            },
+            [&](size_t ring, uint64_t lost) {
+                // Every book waits for its next snapshot; the ring's symbols are not known here
+                std::cerr << "Ring " << ring << " lapped this reader, " << lost << " records lost" << std::endl;
+                for (size_t i = 0; i < books.size(); i++) books[i].synced = false;
+            });
+        if (!read) std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+        int64_t nowNs = monotonicNowNs();
+        if (nowNs < nextPrintNs) continue;
+        nextPrintNs = nowNs + interval * 1000000000LL;
+
+        for (size_t i = 0; i < books.size(); i++) {
+            const TailBook& book = books[i];
+            std::string symbol(reader.symbolName(static_cast<uint32_t>(i)));
+            if (!book.synced || book.bids.empty() || book.asks.empty()) {
+                std::printf("%-14s waiting for a snapshot\n", symbol.c_str());
+                continue;
+            }
+            char bid[48], ask[48], bidQty[48], askQty[48];
+            const auto& [bidPrice, bidVolume] = *book.bids.begin();
+            const auto& [askPrice, askVolume] = *book.asks.begin();
+            formatFixed(bid, sizeof(bid), bidPrice, book.priceDecimals, book.priceDecimals);
+            formatFixed(ask, sizeof(ask), askPrice, book.priceDecimals, book.priceDecimals);
+            formatFixed(bidQty, sizeof(bidQty), bidVolume, book.qtyDecimals, book.qtyDecimals);
+            formatFixed(askQty, sizeof(askQty), askVolume, book.qtyDecimals, book.qtyDecimals);
+            std::printf("%-14s bid %s x %s  ask %s x %s  levels %zu / %zu  version %llu\n", symbol.c_str(), bid,
+                        bidQty, ask, askQty, book.bids.size(), book.asks.size(),
+                        static_cast<unsigned long long>(book.version));
+        }
+        std::printf("%llu records, %llu updates in %lds, mean feed->tail %.1f us, %llu lost\n",
+                    static_cast<unsigned long long>(records), static_cast<unsigned long long>(updates), interval,
+                    updates ? latencySumNs / 1000.0 / updates : 0.0,
+                    static_cast<unsigned long long>(reader.lost()));
+        std::fflush(stdout);
+        records = 0;
+        updates = 0;
+        latencySumNs = 0;
+    }
+    return 0;
+}